@@ -0,0 +1,573 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "benchmark.h"
+
+static double benchmark_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static size_t benchmark_allocations(void) {
+#if defined(PROGRAM_ALLOCATION_STATISTICS) && PROGRAM_ALLOCATION_STATISTICS == true
+    return __atomic_load_n(&program_allocations, __ATOMIC_RELAXED);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Struct that contains the measures of a benchmark.
+ */
+typedef struct benchmark_result {
+    double seconds; /**< Time spent by every query */
+    size_t queries; /**< How many queries have been measured */
+    size_t allocations; /**< Calls to the allocator made by every query */
+    uint_fast64_t nodes; /**< Nodes expanded by every query */
+    uint_fast64_t length; /**< Sum of the lengths of the found paths */
+    double search; /**< Time spent expanding the nodes, when only a part of seconds */
+} benchmark_result_t;
+
+static void benchmark_report(const char *name, benchmark_result_t result) {
+    double queries = (double) result.queries;
+    printf("    %-28s %10.2f us/query", name, result.seconds * 1e6 / queries);
+
+    // Searches that don't expose their counters report no nodes.
+    if (result.nodes > 0)
+        printf(" %10.1f nodes/query %12.0f nodes/s", (double) result.nodes / queries,
+               (double) result.nodes / (result.search > 0 ? result.search : result.seconds));
+    else
+        printf(" %10s nodes/query %12s nodes/s", "-", "-");
+
+    printf(" %8.1f length/query", (double) result.length / queries);
+
+#if defined(PROGRAM_ALLOCATION_STATISTICS) && PROGRAM_ALLOCATION_STATISTICS == true
+    printf(" %10.2f allocations/query", (double) result.allocations / queries);
+#endif
+
+    putchar('\n');
+}
+
+static path_t benchmark_targets(maze_t maze) {
+    path_t coins = NULL, targets = NULL;
+
+    for (int i = 0; i < maze.width * maze.height; ++i) {
+        if (maze.blocks[i] == SNAKE_COIN_CHAR) {
+            location_t coin = {i % maze.width, i / maze.width};
+            cvector_push_back(coins, coin);
+        }
+    }
+
+    // Coins are sampled evenly so large mazes keep the same number of queries.
+    size_t step = cvector_size(coins) / BENCHMARK_TARGETS + 1;
+    for (size_t i = 0; i < cvector_size(coins); i += step)
+        cvector_push_back(targets, coins[i]);
+
+    cvector_push_back(targets, maze.end);
+    cvector_free(coins);
+    return targets;
+}
+
+static benchmark_result_t benchmark_astar_allocating(maze_t maze, path_t targets) {
+    benchmark_result_t result = {0, BENCHMARK_ROUNDS * cvector_size(targets)};
+
+    // Every query allocates its own buffers.
+    size_t allocations = benchmark_allocations();
+    double before = benchmark_now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (size_t i = 0; i < cvector_size(targets); ++i) {
+            path_t path = solver_execute_astar(maze, maze.start, targets[i], NULL, true);
+            result.length += cvector_size(path);
+            cvector_free(path);
+        }
+    }
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+
+    return result;
+}
+
+static benchmark_result_t benchmark_astar_workspace(maze_t maze, path_t targets, solver_order_t order,
+                                                    queue_kind_t kind) {
+    benchmark_result_t result = {0, BENCHMARK_ROUNDS * cvector_size(targets)};
+
+    // Every query reuses the same workspace and path.
+    solver_workspace_t w;
+    path_t path = NULL;
+
+    solver_init_workspace(&w, maze);
+    solver_set_workspace_queue(&w, kind);
+    w.order = order;
+
+    size_t allocations = benchmark_allocations();
+    double before = benchmark_now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (size_t i = 0; i < cvector_size(targets); ++i) {
+            solver_execute_astar_into(&w, maze, maze.start, targets[i], NULL, true, &path);
+            result.length += cvector_size(path);
+        }
+    }
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+    result.nodes = w.expanded;
+
+    cvector_free(path);
+    solver_free_workspace(w);
+
+    return result;
+}
+
+static benchmark_result_t benchmark_bidirectional(maze_t maze, path_t targets) {
+    benchmark_result_t result = {0, BENCHMARK_ROUNDS * cvector_size(targets)};
+
+    solver_workspace_t forward, backward;
+    path_t path = NULL;
+
+    solver_init_workspace(&forward, maze);
+    solver_init_workspace(&backward, maze);
+
+    size_t allocations = benchmark_allocations();
+    double before = benchmark_now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (size_t i = 0; i < cvector_size(targets); ++i) {
+            solver_execute_bidirectional_into(&forward, &backward, maze, maze.start, targets[i], &path);
+            result.length += cvector_size(path);
+        }
+    }
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+    result.nodes = forward.expanded + backward.expanded;
+
+    cvector_free(path);
+    solver_free_workspace(forward);
+    solver_free_workspace(backward);
+
+    return result;
+}
+
+static benchmark_result_t benchmark_jps(maze_t maze, path_t targets) {
+    benchmark_result_t result = {0, BENCHMARK_ROUNDS * cvector_size(targets)};
+
+    solver_workspace_t w;
+    path_t path = NULL;
+
+    solver_init_workspace(&w, maze);
+
+    size_t allocations = benchmark_allocations();
+    double before = benchmark_now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (size_t i = 0; i < cvector_size(targets); ++i) {
+            solver_execute_jps_into(&w, maze, maze.start, targets[i], &path);
+            result.length += cvector_size(path);
+        }
+    }
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+    result.nodes = w.expanded;
+
+    cvector_free(path);
+    solver_free_workspace(w);
+
+    return result;
+}
+
+static void benchmark_full(const char *name, maze_t maze, solver_frontier_key_t key) {
+    benchmark_result_t result = {0, 1};
+
+    // A single run, the full solver can take up to PROGRAM_SOLVER_TIMEOUT seconds.
+    solver_statistics_t statistics;
+    size_t allocations = benchmark_allocations();
+    path_t path = solver_execute_full_with(maze, key, &statistics);
+
+    result.seconds = statistics.estimation + statistics.seconds;
+    result.search = statistics.seconds;
+    result.allocations = benchmark_allocations() - allocations;
+    result.nodes = statistics.expanded;
+    result.length = cvector_size(path);
+    benchmark_report(name, result);
+
+    printf("      estimation    %10.2f us\n", statistics.estimation * 1e6);
+
+    if (PROGRAM_SOLVER_TRANSPOSITION_BITS > 0) {
+        printf("      transposition %10lu hits %10lu misses %10lu overwrites\n",
+               (unsigned long) statistics.transposition_hits, (unsigned long) statistics.transposition_misses,
+               (unsigned long) statistics.transposition_overwrites);
+    }
+
+    if (PROGRAM_SOLVER_PARETO) {
+        printf("      labels        %10lu dominated %10lu removed\n",
+               (unsigned long) statistics.labels_dominated, (unsigned long) statistics.labels_removed);
+    }
+
+    cvector_free(path);
+}
+
+static void benchmark_tour(maze_t maze) {
+    benchmark_result_t result = {0, 1};
+
+    double before = benchmark_now();
+    size_t allocations = benchmark_allocations();
+    tour_matrix_t matrix;
+    tour_init_matrix(&matrix, maze);
+    double built = benchmark_now();
+
+    tour_t tour = tour_solve(&matrix);
+    path_t path = tour ? tour_stitch(&matrix, maze, tour, NULL) : NULL;
+
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+    result.length = cvector_size(path);
+    benchmark_report("tour", result);
+
+    printf("      matrix        %10zu points %10.2f us\n", matrix.size, (built - before) * 1e6);
+
+    if (tour) {
+        // The local search is measured on its own, starting from the path of the tour.
+        tour_t improved = tour_extract(&matrix, maze, path);
+        double started = benchmark_now();
+        size_t moves = tour_improve(&matrix, &improved, solver_now() + PROGRAM_SOLVER_TIMEOUT);
+        path_t refined = tour_stitch(&matrix, maze, improved, NULL);
+
+        printf("      local search  %10zu moves %10.2f us %10ld score %10ld before\n", moves,
+               (benchmark_now() - started) * 1e6, (long) solver_score(refined), (long) solver_score(path));
+
+        cvector_free(refined);
+        cvector_free(improved);
+    }
+
+    cvector_free(path);
+    cvector_free(tour);
+    tour_free_matrix(matrix);
+}
+
+static void benchmark_tree(maze_t maze) {
+    benchmark_result_t result = {0, 1};
+
+    size_t allocations = benchmark_allocations();
+    double before = benchmark_now();
+    path_t path = tree_execute(maze);
+
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+    result.length = cvector_size(path);
+    benchmark_report("tree", result);
+
+    // Mazes with cycles or drills are left to the other solvers.
+    if (path)
+        printf("      tree          %10ld score\n", (long) solver_score(path));
+    else
+        printf("      tree          %10s score\n", "-");
+
+    cvector_free(path);
+}
+
+static void benchmark_beam(maze_t maze, size_t width, solver_beam_rank_t rank) {
+    benchmark_result_t result = {0, 1};
+    char name[32];
+    snprintf(name, sizeof(name), "beam (%s, width %zu)", rank == SOLVER_BEAM_SCORE ? "score" : "optimistic", width);
+
+    solver_statistics_t statistics;
+    size_t allocations = benchmark_allocations();
+    path_t path = solver_execute_beam(maze, width, rank, NULL, &statistics);
+
+    result.seconds = statistics.estimation + statistics.seconds;
+    result.search = statistics.seconds;
+    result.allocations = benchmark_allocations() - allocations;
+    result.nodes = statistics.expanded;
+    result.length = cvector_size(path);
+    benchmark_report(name, result);
+
+    if (path)
+        printf("      score         %10ld\n", 1000 - (long) cvector_size(path) + 1 + 10 * (long) cvector_last(path)->coins);
+
+    cvector_free(path);
+}
+
+static void benchmark_parallel(maze_t maze) {
+    double single = 0;
+
+    for (size_t threads = 1; threads <= BENCHMARK_THREADS; threads *= 2) {
+        benchmark_result_t result = {0, 1};
+        char name[32];
+        snprintf(name, sizeof(name), "parallel (%zu threads)", threads);
+
+        solver_statistics_t statistics;
+        solver_control_t control = {solver_now() + PROGRAM_SOLVER_TIMEOUT, PROGRAM_SOLVER_FULL_PRECISION};
+        size_t allocations = benchmark_allocations();
+        path_t path = solver_execute_parallel(maze, threads, &control, &statistics);
+
+        result.seconds = statistics.estimation + statistics.seconds;
+        result.search = statistics.seconds;
+        result.allocations = benchmark_allocations() - allocations;
+        result.nodes = statistics.expanded;
+        result.length = cvector_size(path);
+        benchmark_report(name, result);
+
+        // The speedup is measured on the search, the estimation runs on a single thread.
+        if (threads == 1)
+            single = statistics.seconds;
+
+        printf("      speedup       %10.2fx %10lu steals %10ld score\n", single / statistics.seconds,
+               (unsigned long) statistics.steals, (long) solver_score(path));
+
+        cvector_free(path);
+    }
+}
+
+static void benchmark_portfolio(maze_t maze) {
+    benchmark_result_t result = {0, 1};
+
+    double before = benchmark_now();
+    size_t allocations = benchmark_allocations();
+    portfolio_result_t portfolio = portfolio_execute(maze, PORTFOLIO_ALL, solver_now() + PROGRAM_SOLVER_TIMEOUT);
+
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+    result.length = cvector_size(portfolio.path);
+    benchmark_report("portfolio", result);
+
+    for (size_t i = 0; i < PORTFOLIO_STRATEGIES; ++i) {
+        portfolio_entry_t entry = portfolio.entries[i];
+        const char *outcome = portfolio.path && i == portfolio.winner ? portfolio.proven ? " winner, proven" : " winner" : "";
+
+        if (entry.path)
+            printf("      %-13s %10ld score %10.2f us%s\n", portfolio_name(i), (long) entry.score, entry.seconds * 1e6,
+                   outcome);
+        else
+            printf("      %-13s %10s score %10.2f us\n", portfolio_name(i), "-", entry.seconds * 1e6);
+    }
+
+    portfolio_free(portfolio);
+}
+
+static void benchmark_astar(maze_t maze, path_t targets) {
+    benchmark_report("astar", benchmark_astar_allocating(maze, targets));
+    benchmark_report("astar (workspace)",
+                     benchmark_astar_workspace(maze, targets, SOLVER_ORDER_ASTAR, PROGRAM_SOLVER_QUEUE));
+    benchmark_report("astar (accumulated order)",
+                     benchmark_astar_workspace(maze, targets, SOLVER_ORDER_ACCUMULATED, PROGRAM_SOLVER_QUEUE));
+    benchmark_report("astar (heap queue)",
+                     benchmark_astar_workspace(maze, targets, SOLVER_ORDER_ASTAR, QUEUE_HEAP));
+    benchmark_report("astar (bucket queue)",
+                     benchmark_astar_workspace(maze, targets, SOLVER_ORDER_ASTAR, QUEUE_BUCKET));
+    benchmark_report("bidirectional astar", benchmark_bidirectional(maze, targets));
+    benchmark_report("jump point search", benchmark_jps(maze, targets));
+}
+
+static void benchmark_solver(maze_t maze) {
+    benchmark_tree(maze);
+    benchmark_tour(maze);
+
+    if (maze.width * maze.height > BENCHMARK_FULL_AREA)
+        return;
+
+    benchmark_parallel(maze);
+    benchmark_portfolio(maze);
+
+    for (size_t width = 1; width <= BENCHMARK_BEAM_WIDTH; width *= 16) {
+        benchmark_beam(maze, width, SOLVER_BEAM_SCORE);
+        benchmark_beam(maze, width, SOLVER_BEAM_OPTIMISTIC);
+    }
+
+    benchmark_full("full (cost frontier)", maze, SOLVER_FRONTIER_COST);
+    benchmark_full("full (score frontier)", maze, SOLVER_FRONTIER_SCORE);
+    benchmark_full("full (depth frontier)", maze, SOLVER_FRONTIER_DEPTH);
+
+    // The same search on the copy used by the ai mode, without the dead ends.
+    maze_t view = core_duplicate_maze(maze);
+    double before = benchmark_now();
+    size_t filled = reduction_fill_dead_ends(view);
+    double after = benchmark_now();
+
+    printf("    dead ends     %10zu filled %10.2f us\n", filled, (after - before) * 1e6);
+
+    if (filled > 0)
+        benchmark_full("full (dead ends filled)", view, SOLVER_FRONTIER_COST);
+
+    core_free_maze(view);
+}
+
+static void benchmark_components(maze_t maze) {
+    benchmark_result_t result = {0, BENCHMARK_ROUNDS};
+    components_t components;
+
+    size_t allocations = benchmark_allocations();
+    double before = benchmark_now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        components_init(&components, maze);
+
+        if (round + 1 < BENCHMARK_ROUNDS)
+            components_free(components);
+    }
+    result.seconds = benchmark_now() - before;
+    result.allocations = benchmark_allocations() - allocations;
+    benchmark_report("components", result);
+
+    maze_t view = core_duplicate_maze(maze);
+    size_t removed = components_prune(&components, view);
+
+    printf("      components    %10lu labels %10lu neighbors %10zu unreachable coins\n",
+           (unsigned long) components.count, (unsigned long) components.offsets[components.count] / 2, removed);
+
+    core_free_maze(view);
+    components_free(components);
+}
+
+static void benchmark_graph(maze_t maze) {
+    benchmark_result_t result = {0, 1};
+    graph_t graph;
+
+    size_t allocations = benchmark_allocations();
+    double before = benchmark_now();
+    graph_init(&graph, maze, false);
+    double built = benchmark_now();
+
+    // The shortest path is searched on the edges and expanded back into blocks.
+    uint32_t from = graph.nodes[(size_t) maze.start.x + (size_t) maze.start.y * maze.width];
+    uint32_t to = graph.nodes[(size_t) maze.end.x + (size_t) maze.end.y * maze.width];
+    path_t path = graph_execute_shortest(&graph, maze, true, from, to);
+
+    result.seconds = benchmark_now() - built;
+    result.allocations = benchmark_allocations() - allocations;
+    result.length = cvector_size(path);
+    benchmark_report("junction graph", result);
+
+    size_t open = 0;
+    for (size_t i = 0; i < (size_t) maze.width * maze.height; ++i)
+        open += maze.blocks[i] != SNAKE_WALL_CHAR;
+
+    printf("      graph         %10lu nodes %10zu blocks %10lu edges %10.2f us\n", (unsigned long) graph.count, open,
+           (unsigned long) graph.offsets[graph.count] / 2, (built - before) * 1e6);
+
+    cvector_free(path);
+    graph_free(graph);
+}
+
+static void benchmark_maze(const char *name, maze_t maze) {
+    printf("%s (%dx%d)\n", name, maze.width, maze.height);
+    benchmark_components(maze);
+    benchmark_graph(maze);
+
+    path_t targets = benchmark_targets(maze);
+    benchmark_astar(maze, targets);
+    benchmark_solver(maze);
+    cvector_free(targets);
+}
+
+static size_t benchmark_verify_maze(const char *name, maze_t maze) {
+    solver_workspace_t w, forward, backward;
+    path_t targets = benchmark_targets(maze), path = NULL;
+    size_t failures = 0;
+
+    solver_init_workspace(&w, maze);
+    solver_init_workspace(&forward, maze);
+    solver_init_workspace(&backward, maze);
+
+    // The three searches are exact, the paths can differ but not their length.
+    for (size_t i = 0; i < cvector_size(targets); ++i) {
+        bool found = solver_execute_astar_into(&w, maze, maze.start, targets[i], NULL, true, &path);
+        size_t astar = found ? cvector_size(path) : 0;
+
+        found = solver_execute_bidirectional_into(&forward, &backward, maze, maze.start, targets[i], &path);
+        size_t bidirectional = found ? cvector_size(path) : 0;
+
+        found = solver_execute_jps_into(&w, maze, maze.start, targets[i], &path);
+        size_t jps = found ? cvector_size(path) : 0;
+
+        if (astar != bidirectional || astar != jps) {
+            fprintf(stderr, "%s: target (%d, %d) has length %zu with a*, %zu bidirectional, %zu jps\n", name,
+                    targets[i].x, targets[i].y, astar, bidirectional, jps);
+            failures++;
+        }
+    }
+
+    printf("%s: %zu targets, %zu failures\n", name, cvector_size(targets), failures);
+
+    cvector_free(path);
+    cvector_free(targets);
+    solver_free_workspace(w);
+    solver_free_workspace(forward);
+    solver_free_workspace(backward);
+    return failures;
+}
+
+size_t benchmark_verify(char **files, int count) {
+    size_t failures = 0;
+
+    for (int i = 0; i < count; ++i) {
+        FILE *file = fopen(files[i], "r");
+
+        if (file == NULL) {
+            fprintf(stderr, "Unable to open %s\n", files[i]);
+            failures++;
+            continue;
+        }
+
+        maze_t maze = core_parse_maze(file);
+        fclose(file);
+
+        if (maze.width == 0 || maze.height == 0) {
+            fprintf(stderr, "Unable to parse %s\n", files[i]);
+            failures++;
+            continue;
+        }
+
+        failures += benchmark_verify_maze(files[i], maze);
+        core_free_maze(maze);
+    }
+
+    return failures;
+}
+
+void benchmark_run(char **files, int count) {
+    for (int i = 0; i < count; ++i) {
+        FILE *file = fopen(files[i], "r");
+
+        if (file == NULL) {
+            fprintf(stderr, "Unable to open %s\n", files[i]);
+            continue;
+        }
+
+        maze_t maze = core_parse_maze(file);
+        fclose(file);
+
+        if (maze.width == 0 || maze.height == 0) {
+            fprintf(stderr, "Unable to parse %s\n", files[i]);
+            continue;
+        }
+
+        benchmark_maze(files[i], maze);
+        core_free_maze(maze);
+    }
+
+    srand(BENCHMARK_SEED);
+
+    maze_data_t sizes[] = {51, 127, 254};
+    for (int i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i) {
+        maze_t maze = {sizes[i], sizes[i]};
+        core_init_maze(&maze);
+        generator_create(&maze);
+
+        benchmark_maze("generated", maze);
+        core_free_maze(maze);
+    }
+
+    // An open room with some coins, where the corridors of the generator are missing.
+    maze_t room = {254, 254};
+    core_init_maze(&room);
+    core_fill_maze(room, ' ');
+    for (int i = 0; i < room.width * room.height; ++i) {
+        if (rand() % 100 == 0)
+            room.blocks[i] = SNAKE_COIN_CHAR;
+    }
+
+    room.start = (location_t) {0, 0};
+    room.end = (location_t) {room.width - 1, room.height - 1};
+    core_set_block(room, room.start, SNAKE_PLAYER_CHAR);
+    core_set_block(room, room.end, SNAKE_END_CHAR);
+
+    benchmark_maze("open", room);
+    core_free_maze(room);
+}
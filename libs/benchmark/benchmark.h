@@ -0,0 +1,92 @@
+/**
+ * @file benchmark.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the benchmark of the solvers
+ *
+ * These file contains functions to measure the solvers
+ * on mazes parsed from files and on generated mazes,
+ * printing the results to stdout.
+ */
+
+#ifndef SNAKE_BENCHMARK_H
+#define SNAKE_BENCHMARK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../configuration.h"
+#include "../core/core.h"
+#include "../generator/generator.h"
+#include "../solver/solver.h"
+#include "../tour/tour.h"
+#include "../portfolio/portfolio.h"
+#include "../components/components.h"
+#include "../reduction/reduction.h"
+#include "../graph/graph.h"
+#include "../tree/tree.h"
+
+/**
+ * @details Seed used to generate the mazes of the benchmark,
+ * fixed so that every run measures the same mazes.
+ */
+#define BENCHMARK_SEED 896018
+
+/**
+ * @details How many times every measured query is repeated.
+ */
+#define BENCHMARK_ROUNDS 5
+
+/**
+ * @details Maximum number of coins used as targets
+ * of the measured queries on every maze.
+ */
+#define BENCHMARK_TARGETS 32
+
+/**
+ * @details Largest area of the mazes where the full
+ * solver and the beam search are measured, on larger
+ * mazes a single run can take up to PROGRAM_SOLVER_TIMEOUT seconds.
+ */
+#define BENCHMARK_FULL_AREA (64 * 64)
+
+/**
+ * @details Widest beam measured, the widths
+ * grow by a factor of 16 starting from 1.
+ */
+#define BENCHMARK_BEAM_WIDTH 256
+
+/**
+ * @details Most threads measured by the parallel
+ * solver, the threads double starting from 1.
+ */
+#define BENCHMARK_THREADS 8
+
+/**
+ * @brief Runs the benchmark
+ *
+ * Every file in @p files is parsed as a maze and measured,
+ * then the mazes produced by generator_create are measured
+ * up to the maximum size of 254x254.
+ *
+ * @param files Paths of the mazes to measure
+ * @param count How many paths are stored in @p files
+ */
+void benchmark_run(char **files, int count);
+
+/**
+ * @brief Checks that the searches agree
+ *
+ * Every file in @p files is parsed as a maze and the paths from the
+ * start to the targets measured by the benchmark are searched with
+ * a*, bidirectional a* and jump point search, the three must have
+ * the same length. The failures are printed to stderr.
+ *
+ * @param files Paths of the mazes to check
+ * @param count How many paths are stored in @p files
+ * @return How many targets or files failed the check.
+ */
+size_t benchmark_verify(char **files, int count);
+
+#endif //SNAKE_BENCHMARK_H
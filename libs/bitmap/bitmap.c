@@ -0,0 +1,22 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "bitmap.h"
+
+static size_t bitmap_words(size_t size) {
+    return (size + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS;
+}
+
+void bitmap_init(bitmap_t *bitmap, size_t size) {
+    bitmap->words = (bitmap_word_t *) PROGRAM_CALLOC(bitmap_words(size) + 1, sizeof(bitmap_word_t));
+    bitmap->size = size;
+}
+
+void bitmap_free(bitmap_t bitmap) {
+    PROGRAM_FREE(bitmap.words);
+}
+
+void bitmap_clear(bitmap_t bitmap) {
+    memset(bitmap.words, 0, bitmap_words(bitmap.size) * sizeof(bitmap_word_t));
+}
@@ -0,0 +1,97 @@
+/**
+ * @file bitmap.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains a fixed size set of bits
+ *
+ * These file contains functions and macros to mark
+ * blocks of the maze using a single bit for each of them,
+ * useful to test if a block belongs to a set in constant time.
+ */
+
+#ifndef SNAKE_BITMAP_H
+#define SNAKE_BITMAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../configuration.h"
+#include "../rpmalloc/rpmalloc.h"
+
+/**
+ * @brief Word used to store the bits.
+ */
+typedef uint64_t bitmap_word_t;
+
+/**
+ * @details How many bits are stored inside a bitmap_word_t
+ */
+#define BITMAP_WORD_BITS 64
+
+/**
+ * @brief Struct that represents a set of bits.
+ */
+typedef struct bitmap {
+    bitmap_word_t *words; /**< Pointer to the first word of the set */
+    size_t size; /**< How many bits are stored */
+} bitmap_t;
+
+/**
+ * @brief Checks if a bit is set.
+ *
+ * @param bitmap The bitmap_t to be checked
+ * @param index Position of the bit
+ * @return Non-zero if the bit is set.
+ */
+#define bitmap_test(bitmap, index) \
+    (((bitmap).words[(index) / BITMAP_WORD_BITS] >> ((index) % BITMAP_WORD_BITS)) & 1u)
+
+/**
+ * @brief Sets a bit.
+ *
+ * @param bitmap The bitmap_t where to apply changes
+ * @param index Position of the bit
+ */
+#define bitmap_set(bitmap, index) \
+    ((bitmap).words[(index) / BITMAP_WORD_BITS] |= (bitmap_word_t) 1 << ((index) % BITMAP_WORD_BITS))
+
+/**
+ * @brief Resets a bit.
+ *
+ * @param bitmap The bitmap_t where to apply changes
+ * @param index Position of the bit
+ */
+#define bitmap_reset(bitmap, index) \
+    ((bitmap).words[(index) / BITMAP_WORD_BITS] &= ~((bitmap_word_t) 1 << ((index) % BITMAP_WORD_BITS)))
+
+/**
+ * @brief Allocates space for the bitmap
+ *
+ * Every bit is initialized to 0.
+ *
+ * Remember after using the bitmap to free the allocated
+ * memory by calling bitmap_free.
+ *
+ * @param bitmap Pointer to the bitmap object
+ * @param size How many bits should be stored
+ */
+void bitmap_init(bitmap_t *bitmap, size_t size)__attribute__((nonnull));
+
+/**
+ * @brief Frees the bitmap used space.
+ *
+ * @param bitmap Bitmap that needs to be deallocated
+ * @warning bitmap_init must be called before calling this function.
+ */
+void bitmap_free(bitmap_t bitmap);
+
+/**
+ * @brief Resets every bit of the bitmap.
+ *
+ * @param bitmap The bitmap_t where to apply changes
+ */
+void bitmap_clear(bitmap_t bitmap);
+
+#endif //SNAKE_BITMAP_H
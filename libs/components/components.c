@@ -0,0 +1,181 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "components.h"
+
+static uint32_t components_find(uint32_t *parents, uint32_t block) {
+    // Path halving: every visited block is linked to its grandparent.
+    while (parents[block] != block) {
+        parents[block] = parents[parents[block]];
+        block = parents[block];
+    }
+
+    return block;
+}
+
+static void components_union(uint32_t *parents, uint32_t first, uint32_t second) {
+    first = components_find(parents, first);
+    second = components_find(parents, second);
+
+    // The smaller root is kept, so every root is the first block of its component.
+    if (first < second)
+        parents[second] = first;
+    else if (second < first)
+        parents[first] = second;
+}
+
+static int components_compare_pairs(const void *a, const void *b) {
+    uint64_t first = *(const uint64_t *) a, second = *(const uint64_t *) b;
+    return (first > second) - (first < second);
+}
+
+void components_init(components_t *components, maze_t maze) {
+    uint32_t cells = (uint32_t) maze.width * maze.height;
+    uint32_t end = (uint32_t) maze.end.x + (uint32_t) maze.end.y * maze.width;
+    uint32_t *parents = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+
+    components->labels = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    components->count = 0;
+
+    for (uint32_t i = 0; i < cells; ++i) {
+        parents[i] = i;
+
+        if (maze.blocks[i] == SNAKE_WALL_CHAR || i == end)
+            continue;
+
+        uint32_t x = i % maze.width;
+
+        if (x > 0 && maze.blocks[i - 1] != SNAKE_WALL_CHAR && i - 1 != end)
+            components_union(parents, i, i - 1);
+
+        if (i >= maze.width && maze.blocks[i - maze.width] != SNAKE_WALL_CHAR && i - maze.width != end)
+            components_union(parents, i, i - maze.width);
+    }
+
+    // Roots come before the other blocks of their component, so they are labelled first.
+    for (uint32_t i = 0; i < cells; ++i) {
+        if (maze.blocks[i] == SNAKE_WALL_CHAR) {
+            components->labels[i] = COMPONENTS_NONE;
+        } else {
+            uint32_t root = components_find(parents, i);
+            components->labels[i] = root == i ? components->count++ : components->labels[root];
+        }
+    }
+
+    PROGRAM_FREE(parents);
+
+    /*
+     * Every wall joins the components around it, the pairs are
+     * stored in both directions, sorted and then compressed.
+     */
+    cvector_vector_type(uint64_t) pairs = NULL;
+    for (uint32_t i = 0; i < cells; ++i) {
+        if (maze.blocks[i] != SNAKE_WALL_CHAR)
+            continue;
+
+        location_t wall = {i % maze.width, i / maze.width};
+        uint32_t around[4];
+        uint_fast8_t size = 0;
+
+        for (uint_fast8_t k = 1; k < 5; ++k) {
+            location_t neighbor = core_get_neighbor(wall, k, 1);
+
+            if (!core_is_in_bounds(maze, neighbor))
+                continue;
+
+            uint32_t label = components_label(components, maze, neighbor);
+            if (label != COMPONENTS_NONE)
+                around[size++] = label;
+        }
+
+        for (uint_fast8_t a = 0; a < size; ++a) {
+            for (uint_fast8_t b = 0; b < size; ++b) {
+                if (around[a] != around[b])
+                    cvector_push_back(pairs, (uint64_t) around[a] << 32 | around[b]);
+            }
+        }
+    }
+
+    if (pairs)
+        qsort(pairs, cvector_size(pairs), sizeof(uint64_t), components_compare_pairs);
+
+    components->offsets = (uint32_t *) PROGRAM_CALLOC(components->count + 1, sizeof(uint32_t));
+    components->neighbors = (uint32_t *) PROGRAM_MALLOC((cvector_size(pairs) + 1) * sizeof(uint32_t));
+
+    uint32_t stored = 0;
+    for (size_t i = 0; i < cvector_size(pairs); ++i) {
+        if (i > 0 && pairs[i] == pairs[i - 1])
+            continue;
+
+        components->neighbors[stored++] = (uint32_t) pairs[i];
+        components->offsets[(pairs[i] >> 32) + 1]++;
+    }
+
+    for (uint32_t i = 0; i < components->count; ++i)
+        components->offsets[i + 1] += components->offsets[i];
+
+    cvector_free(pairs);
+}
+
+void components_free(components_t components) {
+    PROGRAM_FREE(components.labels);
+    PROGRAM_FREE(components.offsets);
+    PROGRAM_FREE(components.neighbors);
+}
+
+bool components_connected(const components_t *components, maze_t maze, location_t from, location_t to) {
+    uint32_t label = components_label(components, maze, from);
+
+    if (label == COMPONENTS_NONE)
+        return false;
+
+    if (!core_compare_locations(to, maze.end))
+        return label == components_label(components, maze, to);
+
+    for (uint_fast8_t k = 1; k < 5; ++k) {
+        location_t neighbor = core_get_neighbor(to, k, 1);
+
+        if (core_is_in_bounds(maze, neighbor) && components_label(components, maze, neighbor) == label)
+            return true;
+    }
+
+    return core_compare_locations(from, to);
+}
+
+bool components_adjacent(const components_t *components, uint32_t first, uint32_t second) {
+    uint32_t low = components->offsets[first], high = components->offsets[first + 1];
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+
+        if (components->neighbors[middle] == second)
+            return true;
+
+        if (components->neighbors[middle] < second)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return false;
+}
+
+size_t components_prune(const components_t *components, maze_t maze) {
+    size_t cells = (size_t) maze.width * maze.height, removed = 0;
+    uint32_t start = components_label(components, maze, maze.start);
+
+    for (size_t i = 0; i < cells; ++i) {
+        if (components->labels[i] == start && maze.blocks[i] == SNAKE_DRILL_CHAR)
+            return 0;
+    }
+
+    for (size_t i = 0; i < cells; ++i) {
+        if (maze.blocks[i] == SNAKE_COIN_CHAR && components->labels[i] != start) {
+            maze.blocks[i] = ' ';
+            removed++;
+        }
+    }
+
+    return removed;
+}
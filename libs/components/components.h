@@ -0,0 +1,120 @@
+/**
+ * @file components.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the connected components of a maze
+ *
+ * These file contains functions that label every block of the
+ * maze with the component it belongs to, so that asking if a block
+ * can reach another one without drilling is a couple of lookups.
+ * The components separated by a single wall, that a drill can join,
+ * are stored next to the labels.
+ */
+
+#ifndef SNAKE_COMPONENTS_H
+#define SNAKE_COMPONENTS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../configuration.h"
+#include "../core/core.h"
+#include "../vector/cvector.h"
+
+/**
+ * @details Label of the blocks that don't belong to
+ * any component, the walls.
+ */
+#define COMPONENTS_NONE UINT32_MAX
+
+/**
+ * @brief Struct that contains the connected components of a maze.
+ *
+ * Two blocks are in the same component when they can reach each
+ * other walking on blocks that are not walls. The end is never
+ * crossed, as the game ends on it, so it is a component on its own.
+ *
+ * The neighbors of a component are stored as a compressed adjacency
+ * list: the components that a single wall block separates from the
+ * component @c i are <tt>neighbors[offsets[i]]</tt> until
+ * <tt>neighbors[offsets[i + 1]]</tt>, sorted.
+ */
+typedef struct components {
+    uint32_t *labels; /**< Component of every block, COMPONENTS_NONE for the walls */
+    uint32_t count; /**< How many components are stored */
+    uint32_t *offsets; /**< Where the neighbors of every component start, count + 1 entries */
+    uint32_t *neighbors; /**< Components separated by a single wall, sorted for every component */
+} components_t;
+
+/**
+ * @brief Returns the component of a location.
+ *
+ * @param components Pointer to the components_t
+ * @param maze Maze where the components have been labelled
+ * @param l Location of the block
+ */
+#define components_label(components, maze, l) ((components)->labels[(size_t) (l).x + (size_t) (l).y * (maze).width])
+
+/**
+ * @brief Labels the components of a maze
+ *
+ * Uses a union-find over the blocks, every block is joined
+ * with the block on its left and the one above it, so the
+ * labels are built in a single scan of the maze. The neighbors
+ * are then found scanning the walls.
+ *
+ * Remember after using the components to free the allocated
+ * memory by calling components_free.
+ *
+ * @param components Pointer to the components object
+ * @param maze Maze to be labelled
+ */
+void components_init(components_t *components, maze_t maze)__attribute__((nonnull));
+
+/**
+ * @brief Frees the components used space.
+ *
+ * @param components Components that need to be deallocated
+ * @warning components_init must be called before calling this function.
+ */
+void components_free(components_t components);
+
+/**
+ * @brief Checks if a block can reach another one without drilling.
+ *
+ * When @p to is the end it's enough for @p from to reach
+ * one of the blocks next to it.
+ *
+ * @param components Pointer to the components object
+ * @param maze Maze where the components have been labelled
+ * @param from First location
+ * @param to Second location
+ * @return True if a path without walls joins the locations.
+ */
+bool components_connected(const components_t *components, maze_t maze, location_t from, location_t to)__attribute__((nonnull));
+
+/**
+ * @brief Checks if two components are separated by a single wall.
+ *
+ * @param components Pointer to the components object
+ * @param first First component
+ * @param second Second component
+ * @return True if drilling a single wall joins the components.
+ */
+bool components_adjacent(const components_t *components, uint32_t first, uint32_t second)__attribute__((nonnull));
+
+/**
+ * @brief Removes the coins that can never be collected
+ *
+ * Without a drill in the component of the start no wall can
+ * be drilled, so the coins of the other components are replaced
+ * by empty blocks. With a drill every coin is kept.
+ *
+ * @param components Pointer to the components of @p maze
+ * @param maze Maze where the coins are removed, usually a copy used by the solvers
+ * @return How many coins have been removed.
+ */
+size_t components_prune(const components_t *components, maze_t maze)__attribute__((nonnull(1)));
+
+#endif //SNAKE_COMPONENTS_H
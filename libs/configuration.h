@@ -8,6 +8,8 @@
 #ifndef SNAKE_CONFIGURATION_H
 #define SNAKE_CONFIGURATION_H
 
+#include <stdbool.h>
+
 // --------------------------------------- //
 
 /**
@@ -30,32 +32,174 @@
  * @details Timeout of the custom solver
  *
  * This time manages for how long the path finder
- * algorithm should run.
+ * algorithm should run, in seconds of wall time.
  */
 #define PROGRAM_SOLVER_TIMEOUT 35
 #define PROGRAM_SOLVER_RUN_SIMPLE false
 #define PROGRAM_SOLVER_FULL_PRECISION false
 #define PROGRAM_SOLVER_IGNORE_TIMEOUT false
 
+/**
+ * @details This macro determinate if the ai mode should
+ * use the tour solver, that chooses the coins on the distances
+ * between them instead of searching every path.
+ *
+ * Set to false by default.
+ */
+#define PROGRAM_SOLVER_RUN_TOUR false
+
+/**
+ * @details Time given to the local search that reorders
+ * the coins of the path found by the ai mode, in seconds
+ * of wall time. The path is replaced only when it improves.
+ *
+ * Set to 0 to disable the local search.
+ *
+ * @see tour_refine
+ */
+#define PROGRAM_SOLVER_IMPROVE_TIMEOUT 1
+
+/**
+ * @details Backend of the priority queue used by the
+ * solvers, QUEUE_HEAP or QUEUE_BUCKET.
+ *
+ * @see queue_kind_t
+ */
+#define PROGRAM_SOLVER_QUEUE QUEUE_HEAP
+
+/**
+ * @details Ordering of the open paths of the full solver,
+ * SOLVER_FRONTIER_COST, SOLVER_FRONTIER_SCORE or SOLVER_FRONTIER_DEPTH.
+ *
+ * @see solver_frontier_key_t
+ */
+#define PROGRAM_SOLVER_FRONTIER SOLVER_FRONTIER_COST
+
+/**
+ * @details Size of the transposition table of the full solver,
+ * the table holds at most 2 ^ bits states (16 bytes each),
+ * smaller mazes use a smaller table.
+ *
+ * Set to 0 to disable the table.
+ */
+#define PROGRAM_SOLVER_TRANSPOSITION_BITS 20
+
+/**
+ * @details This macro determinate if the full solver keeps
+ * only the Pareto optimal (steps, coins, drills) labels of
+ * every block, dropping the paths that are dominated.
+ *
+ * @see solver_labels_t
+ */
+#define PROGRAM_SOLVER_PARETO true
+
+/**
+ * @details This macro determinate the most coin and drill blocks
+ * a maze can have for the full solver to keep the Pareto labels.
+ * Every node stores the set of the blocks it collected, one bit
+ * per block, so above this limit the sets would outweigh the nodes
+ * and the labels are not kept.
+ *
+ * @see PROGRAM_SOLVER_PARETO
+ */
+#define PROGRAM_SOLVER_PARETO_COLLECTABLES 256
+
+/**
+ * @details This macro determinate if the ai mode fills
+ * the dead ends without coins or drills before solving,
+ * the solvers run on a copy of the maze.
+ *
+ * @see reduction_fill_dead_ends
+ */
+#define PROGRAM_SOLVER_FILL_DEAD_ENDS true
+
+/**
+ * @details This macro determinate if the ai mode solves
+ * the mazes shaped like a tree, without cycles and drills,
+ * with the tree solver instead of searching them.
+ *
+ * @see tree_execute
+ */
+#define PROGRAM_SOLVER_TREE true
+
+/**
+ * @details Paths kept after every step when the ai mode
+ * runs the beam search instead of the full solver, 0 runs
+ * the full solver. Can be changed with <tt>--beam</tt>.
+ *
+ * @see solver_execute_beam
+ */
+#define PROGRAM_SOLVER_BEAM_WIDTH 0
+
+/**
+ * @details Ranking of the paths of the beam search,
+ * SOLVER_BEAM_SCORE or SOLVER_BEAM_OPTIMISTIC.
+ *
+ * @see solver_beam_rank_t
+ */
+#define PROGRAM_SOLVER_BEAM_RANK SOLVER_BEAM_OPTIMISTIC
+
+/**
+ * @details Threads used by the full solver in the ai mode,
+ * with more than 1 thread the parallel solver is ran.
+ *
+ * @see solver_execute_parallel
+ */
+#define PROGRAM_SOLVER_THREADS 1
+
+/**
+ * @details Strategies raced by the ai mode, a set built with
+ * PORTFOLIO_BIT, 0 runs a single solver. The winner is printed.
+ *
+ * @see portfolio_execute
+ */
+#define PROGRAM_SOLVER_PORTFOLIO 0
+
 #define CVECTOR_LOGARITHMIC_GROWTH
 
+/**
+ * @details This macro determinate if the calls to the
+ * memory allocator should be counted. The counter is
+ * reported by the benchmark mode.
+ *
+ * Set to false by default, the counter is shared
+ * by every thread.
+ */
+#ifndef PROGRAM_ALLOCATION_STATISTICS
+#define PROGRAM_ALLOCATION_STATISTICS false
+#endif
+
 
 // --------------------------------------- //
 
+#if defined(PROGRAM_ALLOCATION_STATISTICS) && PROGRAM_ALLOCATION_STATISTICS == true
+#include <stddef.h>
+
+/*! \cond PRIVATE */
+extern size_t program_allocations;
+/*! \endcond */
+
+#define PROGRAM_COUNT_ALLOCATION(allocation) \
+    (__atomic_add_fetch(&program_allocations, 1, __ATOMIC_RELAXED), (allocation))
+#else
+#define PROGRAM_COUNT_ALLOCATION(allocation) (allocation)
+#endif
+
 #if defined(PROGRAM_RP_ALLOCATOR) && PROGRAM_RP_ALLOCATOR == true
-#define PROGRAM_MALLOC rpmalloc
+#define PROGRAM_MALLOC(size) PROGRAM_COUNT_ALLOCATION(rpmalloc(size))
 #define PROGRAM_FREE rpfree
-#define PROGRAM_CALLOC rpcalloc
-#define PROGRAM_REALLOC rprealloc
+#define PROGRAM_CALLOC(count, size) PROGRAM_COUNT_ALLOCATION(rpcalloc(count, size))
+#define PROGRAM_REALLOC(pointer, size) PROGRAM_COUNT_ALLOCATION(rprealloc(pointer, size))
+#else
+#define PROGRAM_MALLOC(size) PROGRAM_COUNT_ALLOCATION(malloc(size))
+#define PROGRAM_FREE free
+#define PROGRAM_CALLOC(count, size) PROGRAM_COUNT_ALLOCATION(calloc(count, size))
+#define PROGRAM_REALLOC(pointer, size) PROGRAM_COUNT_ALLOCATION(realloc(pointer, size))
+#endif
+
 #define cvector_clib_free PROGRAM_FREE
 #define cvector_clib_malloc PROGRAM_MALLOC
 #define cvector_clib_calloc PROGRAM_CALLOC
 #define cvector_clib_realloc PROGRAM_REALLOC
-#else
-#define PROGRAM_MALLOC malloc
-#define PROGRAM_FREE free
-#define PROGRAM_CALLOC calloc
-#define PROGRAM_REALLOC realloc
-#endif
 
 #endif //SNAKE_CONFIGURATION_H
@@ -0,0 +1,206 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "graph.h"
+
+static uint32_t graph_neighbor(maze_t maze, uint32_t block, move_t direction) {
+    location_t location = {block % maze.width, block / maze.width};
+    location_t neighbor = core_get_neighbor(location, direction, 1);
+
+    if (!core_is_in_bounds(maze, neighbor))
+        return GRAPH_NONE;
+
+    uint32_t index = (uint32_t) neighbor.x + (uint32_t) neighbor.y * maze.width;
+    return maze.blocks[index] == SNAKE_WALL_CHAR ? GRAPH_NONE : index;
+}
+
+static bool graph_is_node(maze_t maze, uint32_t block, bool coins) {
+    int x = (int) (block % maze.width), y = (int) (block / maze.width);
+    maze_data_t data = maze.blocks[block];
+
+    if (data == SNAKE_WALL_CHAR)
+        return false;
+
+    if (data == SNAKE_PLAYER_CHAR || data == SNAKE_END_CHAR || data == SNAKE_DRILL_CHAR ||
+        data == SNAKE_DANGER_CHAR || (coins && data == SNAKE_COIN_CHAR))
+        return true;
+
+    if (x == maze.start.x && y == maze.start.y)
+        return true;
+
+    if (x == maze.end.x && y == maze.end.y)
+        return true;
+
+    uint_fast8_t open = 0;
+    for (uint_fast8_t i = 1; i < 5; ++i)
+        open += graph_neighbor(maze, block, i) != GRAPH_NONE;
+
+    return open != 2;
+}
+
+void graph_init(graph_t *graph, maze_t maze, bool coins) {
+    uint32_t cells = (uint32_t) maze.width * maze.height;
+
+    graph->nodes = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    graph->positions = NULL;
+    graph->edges = NULL;
+    graph->blocks = NULL;
+    graph->count = 0;
+
+    for (uint32_t i = 0; i < cells; ++i) {
+        graph->nodes[i] = GRAPH_NONE;
+
+        if (graph_is_node(maze, i, coins)) {
+            graph->nodes[i] = graph->count++;
+            cvector_push_back(graph->positions, i);
+        }
+    }
+
+    graph->offsets = (uint32_t *) PROGRAM_MALLOC((graph->count + 1) * sizeof(uint32_t));
+
+    /*
+     * Every corridor is walked from each of its nodes: the inner
+     * blocks have exactly two open neighbors, so the next block
+     * is the open neighbor that is not the previous one.
+     */
+    for (uint32_t node = 0; node < graph->count; ++node) {
+        uint32_t origin = graph->positions[node];
+        graph->offsets[node] = (uint32_t) cvector_size(graph->edges);
+
+        for (uint_fast8_t i = 1; i < 5; ++i) {
+            uint32_t first = graph_neighbor(maze, origin, i);
+
+            if (first == GRAPH_NONE)
+                continue;
+
+            graph_edge_t edge = {GRAPH_NONE, 1, (uint32_t) cvector_size(graph->blocks), 0};
+            uint32_t previous = origin, current = first;
+
+            while (graph->nodes[current] == GRAPH_NONE) {
+                cvector_push_back(graph->blocks, current);
+                edge.coins += maze.blocks[current] == SNAKE_COIN_CHAR;
+
+                for (uint_fast8_t k = 1; k < 5; ++k) {
+                    uint32_t next = graph_neighbor(maze, current, k);
+
+                    if (next != GRAPH_NONE && next != previous) {
+                        previous = current;
+                        current = next;
+                        break;
+                    }
+                }
+
+                edge.length++;
+            }
+
+            edge.to = graph->nodes[current];
+            cvector_push_back(graph->edges, edge);
+        }
+    }
+
+    graph->offsets[graph->count] = (uint32_t) cvector_size(graph->edges);
+}
+
+void graph_free(graph_t graph) {
+    PROGRAM_FREE(graph.nodes);
+    PROGRAM_FREE(graph.offsets);
+    cvector_free(graph.positions);
+    cvector_free(graph.edges);
+    cvector_free(graph.blocks);
+}
+
+void graph_distances(const graph_t *graph, maze_t maze, bool dangers, uint32_t origin, uint32_t *distances,
+                     uint32_t *parents, queue_t *queue) {
+    uint32_t end = graph->nodes[(size_t) maze.end.x + (size_t) maze.end.y * maze.width];
+
+    memset(distances, 0xFF, graph->count * sizeof(uint32_t));
+    queue_clear(queue);
+
+    distances[origin] = 0;
+    queue_push(queue, origin, queue_compose_priority(0, 0));
+
+    while (!queue_empty(queue)) {
+        uint32_t node = queue_pop(queue);
+
+        // The game ends on the end, so it can only be the last node of a path.
+        if (node == end && node != origin)
+            continue;
+
+        for (uint32_t i = graph->offsets[node]; i < graph->offsets[node + 1]; ++i) {
+            const graph_edge_t *edge = &graph->edges[i];
+
+            if (!dangers && maze.blocks[graph->positions[edge->to]] == SNAKE_DANGER_CHAR)
+                continue;
+
+            uint32_t distance = distances[node] + edge->length;
+            if (distance >= distances[edge->to])
+                continue;
+
+            distances[edge->to] = distance;
+            if (parents)
+                parents[edge->to] = i;
+
+            queue_push(queue, edge->to, queue_compose_priority(distance, 0));
+        }
+    }
+}
+
+static uint32_t graph_source(const graph_t *graph, uint32_t edge) {
+    // The node whose edges contain the edge, the offsets are sorted.
+    uint32_t low = 0, high = graph->count;
+
+    while (high - low > 1) {
+        uint32_t middle = low + (high - low) / 2;
+
+        if (graph->offsets[middle] <= edge)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+path_t graph_execute_shortest(const graph_t *graph, maze_t maze, bool dangers, uint32_t from, uint32_t to) {
+    uint32_t *distances = (uint32_t *) PROGRAM_MALLOC(graph->count * sizeof(uint32_t));
+    uint32_t *parents = (uint32_t *) PROGRAM_MALLOC(graph->count * sizeof(uint32_t));
+    queue_t queue;
+
+    queue_init(&queue, graph->count, PROGRAM_SOLVER_QUEUE);
+    graph_distances(graph, maze, dangers, from, distances, parents, &queue);
+
+    path_t path = NULL;
+    if (distances[to] != UINT32_MAX) {
+        // The edges are collected backwards, then every one is expanded in order.
+        cvector_vector_type(uint32_t) edges = NULL;
+        for (uint32_t node = to; node != from; node = graph_source(graph, parents[node]))
+            cvector_push_back(edges, parents[node]);
+
+        uint32_t block = graph->positions[from];
+        location_t location = {block % maze.width, block / maze.width};
+        cvector_push_back(path, location);
+
+        for (size_t i = cvector_size(edges); i-- > 0;) {
+            const graph_edge_t *edge = &graph->edges[edges[i]];
+
+            for (uint32_t k = 0; k + 1 < edge->length; ++k) {
+                block = graph->blocks[edge->first + k];
+                location = (location_t) {block % maze.width, block / maze.width};
+                cvector_push_back(path, location);
+            }
+
+            block = graph->positions[edge->to];
+            location = (location_t) {block % maze.width, block / maze.width};
+            cvector_push_back(path, location);
+        }
+
+        solver_collect(maze, path);
+        cvector_free(edges);
+    }
+
+    PROGRAM_FREE(distances);
+    PROGRAM_FREE(parents);
+    queue_free(queue);
+    return path;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file graph.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the junction graph of a maze
+ *
+ * These file contains functions that contract the corridors
+ * of a maze, the blocks with exactly two open neighbors, into
+ * weighted edges between the junctions and the points of interest.
+ * Searches ran on the graph visit far fewer nodes than blocks and
+ * their paths are expanded back into blocks at the end.
+ */
+
+#ifndef SNAKE_GRAPH_H
+#define SNAKE_GRAPH_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../configuration.h"
+#include "../core/core.h"
+#include "../vector/cvector.h"
+#include "../queue/queue.h"
+#include "../solver/solver.h"
+
+/**
+ * @details Node of the blocks that are not nodes,
+ * the walls and the inner blocks of the corridors.
+ */
+#define GRAPH_NONE UINT32_MAX
+
+/**
+ * @brief Struct that represents a corridor between two nodes.
+ *
+ * Every corridor is stored once for each direction, the inner
+ * blocks are stored in the order they are walked.
+ */
+typedef struct graph_edge {
+    uint32_t to; /**< Node reached by the edge */
+    uint32_t length; /**< Steps needed to walk the edge */
+    uint32_t first; /**< Position of the first inner block inside graph_t.blocks */
+    uint16_t coins; /**< Coins on the inner blocks */
+} graph_edge_t;
+
+/**
+ * @brief Struct that represents the junction graph of a maze.
+ *
+ * A block is a node when it's not a wall and it has not exactly
+ * two open neighbors, or when it's the start, the end, a drill, a
+ * danger or, if asked to graph_init, a coin. Every other open block is inside
+ * a corridor and belongs to an edge.
+ *
+ * The edges of the node @c i are <tt>edges[offsets[i]]</tt>
+ * until <tt>edges[offsets[i + 1]]</tt>.
+ */
+typedef struct graph {
+    uint32_t *nodes; /**< Node of every block, GRAPH_NONE if it's not a node */
+    uint32_t *positions; /**< Block of every node */
+    uint32_t count; /**< How many nodes are stored */
+    uint32_t *offsets; /**< Where the edges of every node start, count + 1 entries */
+    graph_edge_t *edges; /**< Edges of every node */
+    uint32_t *blocks; /**< Inner blocks of every edge */
+} graph_t;
+
+/**
+ * @brief Builds the junction graph of a maze
+ *
+ * Every corridor is walked once from each of its ends,
+ * so the graph is built in O(width * height).
+ *
+ * Remember after using the graph to free the allocated
+ * memory by calling graph_free.
+ *
+ * @param graph Pointer to the graph object
+ * @param maze Maze to be contracted
+ * @param coins If the coins are nodes instead of being counted by the edges
+ */
+void graph_init(graph_t *graph, maze_t maze, bool coins)__attribute__((nonnull));
+
+/**
+ * @brief Frees the graph used space.
+ *
+ * @param graph Graph that needs to be deallocated
+ * @warning graph_init must be called before calling this function.
+ */
+void graph_free(graph_t graph);
+
+/**
+ * @brief Computes the distance from a node to every other node
+ *
+ * Dijkstra on the edges, never passing on the end. Without
+ * @p dangers the nodes of the dangers are not walked,
+ * as in the searches on the blocks of tour_init_matrix.
+ *
+ * @param graph Pointer to the graph object
+ * @param maze Maze that has been contracted
+ * @param dangers If the dangers can be walked
+ * @param origin Node where the distances start
+ * @param distances Distance of every node, UINT32_MAX if unreachable
+ * @param parents Edge used to reach every node, can be NULL
+ * @param queue Queue able to hold every node, cleared before the search
+ */
+void graph_distances(const graph_t *graph, maze_t maze, bool dangers, uint32_t origin, uint32_t *distances,
+                     uint32_t *parents, queue_t *queue)__attribute__((nonnull(1, 5, 7)));
+
+/**
+ * @brief Searches the shortest path between two nodes
+ *
+ * Runs graph_distances from @p from and expands the edges
+ * that reach @p to back into blocks.
+ *
+ * @param graph Pointer to the graph object
+ * @param maze Maze that has been contracted
+ * @param dangers If the dangers can be walked
+ * @param from Node where the path starts
+ * @param to Node where the path ends
+ * @return Null if there is no path or a vector of locations to reach @p to from @p from.
+ */
+path_t graph_execute_shortest(const graph_t *graph, maze_t maze, bool dangers, uint32_t from, uint32_t to)__attribute__((nonnull));
+
+#endif //SNAKE_GRAPH_H
@@ -0,0 +1,150 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "portfolio.h"
+
+/**
+ * @brief Struct that contains what a thread of the portfolio needs.
+ */
+typedef struct portfolio_task {
+    pthread_t thread; /**< Thread running the strategy */
+    maze_t maze; /**< Maze where the strategy is ran */
+    portfolio_strategy_t strategy; /**< Strategy ran by the thread */
+    double deadline; /**< Value of solver_now when the strategy stops */
+    bool *cancel; /**< Set when a strategy proves its path, stops the others */
+    portfolio_entry_t *entry; /**< Where the outcome is written */
+} portfolio_task_t;
+
+static const char *portfolio_names[PORTFOLIO_STRATEGIES] = {"simple", "full", "precise", "beam", "tour"};
+
+const char *portfolio_name(portfolio_strategy_t strategy) {
+    return strategy < PORTFOLIO_STRATEGIES ? portfolio_names[strategy] : "none";
+}
+
+static path_t portfolio_tour(maze_t maze, const solver_control_t *control) {
+    // The fallback of tour_execute is the full solver, here it is already racing.
+    tour_matrix_t matrix;
+    tour_init_matrix(&matrix, maze);
+
+    tour_t tour = tour_solve(&matrix);
+    path_t path = tour ? tour_stitch(&matrix, maze, tour, control) : NULL;
+
+    if (PROGRAM_SOLVER_IMPROVE_TIMEOUT > 0 && !solver_expired(control))
+        path = tour_refine_with(&matrix, maze, path,
+                                fmin(control->deadline, solver_now() + PROGRAM_SOLVER_IMPROVE_TIMEOUT));
+
+    cvector_free(tour);
+    tour_free_matrix(matrix);
+    return path;
+}
+
+static void *portfolio_run(void *argument) {
+    portfolio_task_t *task = (portfolio_task_t *) argument;
+    portfolio_entry_t *entry = task->entry;
+    maze_t maze = task->maze;
+    double started = solver_now();
+
+    // Every strategy stops at the deadline or once another one has proven its path.
+    solver_control_t control = {task->deadline, task->strategy == PORTFOLIO_PRECISE, task->cancel};
+    solver_statistics_t statistics = {0};
+
+#if defined(PROGRAM_RP_ALLOCATOR) && PROGRAM_RP_ALLOCATOR == true
+    rpmalloc_thread_initialize();
+#endif
+
+    switch (task->strategy) {
+        case PORTFOLIO_SIMPLE:
+            entry->path = solver_execute_bidirectional(maze, maze.start, maze.end);
+            break;
+        case PORTFOLIO_FULL:
+        case PORTFOLIO_PRECISE:
+            entry->path = solver_execute_controlled(maze, &control, &statistics);
+            break;
+        case PORTFOLIO_BEAM:
+            entry->path = solver_execute_beam(maze, PORTFOLIO_BEAM_WIDTH, PROGRAM_SOLVER_BEAM_RANK, &control, NULL);
+            break;
+        case PORTFOLIO_TOUR:
+            entry->path = portfolio_tour(maze, &control);
+            break;
+        default:
+            break;
+    }
+
+    // Every strategy is scored in the same way, on what its path really collects.
+    if (entry->path)
+        solver_collect(maze, entry->path);
+
+    entry->score = solver_score(entry->path);
+    entry->seconds = solver_now() - started;
+    // Only a precise search that expanded its whole frontier proves that no path scores more.
+    entry->proven = entry->path && task->strategy == PORTFOLIO_PRECISE && statistics.completed;
+
+    if (entry->proven)
+        __atomic_store_n(task->cancel, true, __ATOMIC_RELEASE);
+
+#if defined(PROGRAM_RP_ALLOCATOR) && PROGRAM_RP_ALLOCATOR == true
+    rpmalloc_thread_finalize(1);
+#endif
+
+    return NULL;
+}
+
+portfolio_result_t portfolio_execute(maze_t maze, unsigned strategies, double deadline) {
+    portfolio_result_t result = {NULL, INT_FAST32_MIN, PORTFOLIO_STRATEGIES, false};
+    portfolio_task_t tasks[PORTFOLIO_STRATEGIES];
+    bool cancel = false;
+
+    for (size_t i = 0; i < PORTFOLIO_STRATEGIES; ++i) {
+        portfolio_entry_t *entry = &result.entries[i];
+
+        entry->path = NULL;
+        entry->score = INT_FAST32_MIN;
+        entry->seconds = 0;
+        entry->proven = false;
+        entry->ran = (strategies & PORTFOLIO_BIT(i)) != 0;
+
+        if (!entry->ran)
+            continue;
+
+        tasks[i].maze = maze;
+        tasks[i].strategy = (portfolio_strategy_t) i;
+        tasks[i].deadline = deadline;
+        tasks[i].cancel = &cancel;
+        tasks[i].entry = entry;
+
+        // A strategy whose thread can't be created is reported as not ran.
+        if (pthread_create(&tasks[i].thread, NULL, portfolio_run, &tasks[i]) != 0)
+            entry->ran = false;
+    }
+
+    for (size_t i = 0; i < PORTFOLIO_STRATEGIES; ++i) {
+        portfolio_entry_t *entry = &result.entries[i];
+
+        if (!entry->ran)
+            continue;
+
+        pthread_join(tasks[i].thread, NULL);
+
+        bool better = entry->score > result.score ||
+                      (entry->score == result.score && entry->path &&
+                       entry->seconds < result.entries[result.winner].seconds);
+
+        if (entry->path && better) {
+            result.path = entry->path;
+            result.score = entry->score;
+            result.winner = (portfolio_strategy_t) i;
+        }
+    }
+
+    // The proven path may tie with a faster winner, that is then proven too.
+    for (size_t i = 0; i < PORTFOLIO_STRATEGIES && result.path; ++i)
+        result.proven |= result.entries[i].proven && result.entries[i].score == result.score;
+
+    return result;
+}
+
+void portfolio_free(portfolio_result_t result) {
+    for (size_t i = 0; i < PORTFOLIO_STRATEGIES; ++i)
+        cvector_free(result.entries[i].path);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file portfolio.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the portfolio of solvers
+ *
+ * These file contains functions that run different solvers
+ * on the same maze at the same time, every one on its own thread,
+ * and keep the best path found by any of them.
+ */
+
+#ifndef SNAKE_PORTFOLIO_H
+#define SNAKE_PORTFOLIO_H
+
+#include <pthread.h>
+
+#include "../core/core.h"
+#include "../configuration.h"
+#include "../vector/cvector.h"
+#include "../solver/solver.h"
+#include "../tour/tour.h"
+
+/**
+ * @brief Strategies that can be raced by the portfolio.
+ *
+ * PORTFOLIO_SIMPLE is the bidirectional a* to the end, as ran by
+ * PROGRAM_SOLVER_RUN_SIMPLE. PORTFOLIO_FULL and PORTFOLIO_PRECISE are
+ * the full solver without and with full precision, PORTFOLIO_BEAM is
+ * the beam search and PORTFOLIO_TOUR is the tour solver.
+ */
+typedef enum portfolio_strategy {
+    PORTFOLIO_SIMPLE = 0,
+    PORTFOLIO_FULL = 1,
+    PORTFOLIO_PRECISE = 2,
+    PORTFOLIO_BEAM = 3,
+    PORTFOLIO_TOUR = 4,
+    PORTFOLIO_STRATEGIES = 5
+} portfolio_strategy_t;
+
+/**
+ * @brief Returns the bit of a strategy inside a set of strategies.
+ *
+ * @param strategy portfolio_strategy_t to be converted
+ */
+#define PORTFOLIO_BIT(strategy) (1u << (strategy))
+
+/**
+ * @details Set of every strategy.
+ */
+#define PORTFOLIO_ALL (PORTFOLIO_BIT(PORTFOLIO_STRATEGIES) - 1)
+
+/**
+ * @details Paths kept by the beam search of the portfolio.
+ */
+#define PORTFOLIO_BEAM_WIDTH 64
+
+/**
+ * @brief Struct that contains the outcome of a strategy.
+ */
+typedef struct portfolio_entry {
+    path_t path; /**< Path found by the strategy, NULL if none */
+    int_fast32_t score; /**< Score of the path, INT_FAST32_MIN if none */
+    double seconds; /**< Wall time spent by the strategy */
+    bool ran; /**< If the strategy has been started */
+    bool proven; /**< If the path is proven to be the best one */
+} portfolio_entry_t;
+
+/**
+ * @brief Struct that contains the outcome of a portfolio.
+ *
+ * The entries keep the paths, scores and times of every
+ * strategy, @c path is the path of the winner entry.
+ */
+typedef struct portfolio_result {
+    path_t path; /**< Best path found, NULL if none, owned by the entry of the winner */
+    int_fast32_t score; /**< Score of the best path */
+    portfolio_strategy_t winner; /**< Strategy that found the best path */
+    bool proven; /**< If the best path is proven to be the best one */
+    portfolio_entry_t entries[PORTFOLIO_STRATEGIES]; /**< Outcome of every strategy */
+} portfolio_result_t;
+
+/**
+ * @brief Returns the name of a strategy.
+ *
+ * @param strategy The strategy
+ * @return A static string.
+ */
+const char *portfolio_name(portfolio_strategy_t strategy);
+
+/**
+ * @brief Races a set of strategies on the same maze
+ *
+ * Every strategy of the set runs on its own thread until the deadline.
+ * A path is proven to be the best one when the precise full solver
+ * expands its whole frontier before the deadline, then the strategies
+ * still running are cancelled. The best path is
+ * the one with the highest score, on equal scores the one found in less time.
+ *
+ * Remember after using the result to free the allocated
+ * memory by calling portfolio_free.
+ *
+ * @param maze Maze where the strategies are ran
+ * @param strategies Set of strategies, built with PORTFOLIO_BIT
+ * @param deadline Value of solver_now when the strategies stop
+ * @return The outcome of the portfolio.
+ */
+portfolio_result_t portfolio_execute(maze_t maze, unsigned strategies, double deadline);
+
+/**
+ * @brief Frees the result used space.
+ *
+ * @param result Result that needs to be deallocated
+ */
+void portfolio_free(portfolio_result_t result);
+
+#endif //SNAKE_PORTFOLIO_H
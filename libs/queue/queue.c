@@ -0,0 +1,275 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "queue.h"
+
+#define queue_key(priority) ((uint_fast32_t) ((priority) >> QUEUE_TIE_BITS))
+
+static void heap_place(queue_t *q, size_t position, uint32_t item, queue_priority_t priority) {
+    q->items[position] = item;
+    q->priorities[position] = priority;
+    q->slots[item] = (uint32_t) position + 1;
+}
+
+static void heap_sift_up(queue_t *q, size_t position) {
+    uint32_t item = q->items[position];
+    queue_priority_t priority = q->priorities[position];
+
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+
+        if (q->priorities[parent] <= priority)
+            break;
+
+        heap_place(q, position, q->items[parent], q->priorities[parent]);
+        position = parent;
+    }
+
+    heap_place(q, position, item, priority);
+}
+
+static void heap_sift_down(queue_t *q, size_t position) {
+    uint32_t item = q->items[position];
+    queue_priority_t priority = q->priorities[position];
+
+    for (;;) {
+        size_t child = position * 2 + 1;
+
+        if (child >= q->size)
+            break;
+
+        if (child + 1 < q->size && q->priorities[child + 1] < q->priorities[child])
+            child++;
+
+        if (priority <= q->priorities[child])
+            break;
+
+        heap_place(q, position, q->items[child], q->priorities[child]);
+        position = child;
+    }
+
+    heap_place(q, position, item, priority);
+}
+
+static bool heap_push(queue_t *q, uint32_t item, queue_priority_t priority) {
+    uint32_t slot = q->slots[item];
+
+    if (slot == 0) {
+        heap_place(q, q->size++, item, priority);
+        heap_sift_up(q, q->size - 1);
+        return true;
+    }
+
+    if (priority >= q->priorities[slot - 1])
+        return false;
+
+    q->priorities[slot - 1] = priority;
+    heap_sift_up(q, slot - 1);
+    return true;
+}
+
+static uint32_t heap_pop(queue_t *q) {
+    uint32_t top = q->items[0];
+    q->slots[top] = 0;
+
+    if (--q->size > 0) {
+        heap_place(q, 0, q->items[q->size], q->priorities[q->size]);
+        heap_sift_down(q, 0);
+    }
+
+    return top;
+}
+
+static void bucket_link(queue_t *q, uint32_t item, uint32_t bucket) {
+    uint32_t head = q->heads[bucket];
+
+    q->previous[item] = QUEUE_NONE;
+    q->next[item] = head;
+    if (head != QUEUE_NONE)
+        q->previous[head] = item;
+
+    q->heads[bucket] = item;
+    q->slots[item] = bucket + 1;
+}
+
+static void bucket_unlink(queue_t *q, uint32_t item) {
+    uint32_t bucket = q->slots[item] - 1;
+    uint32_t previous = q->previous[item], next = q->next[item];
+
+    if (previous != QUEUE_NONE)
+        q->next[previous] = next;
+    else
+        q->heads[bucket] = next;
+
+    if (next != QUEUE_NONE)
+        q->previous[next] = previous;
+
+    q->slots[item] = 0;
+}
+
+static void bucket_place(queue_t *q, uint32_t item, queue_priority_t priority) {
+    uint_fast32_t key = queue_key(priority);
+
+    // Keys are monotone, a lower key is queued in the current bucket.
+    if (key < q->base)
+        key = q->base;
+
+    q->priorities[item] = priority;
+    if (key - q->base < QUEUE_BUCKETS) {
+        bucket_link(q, item, key & (QUEUE_BUCKETS - 1));
+    } else {
+        bucket_link(q, item, QUEUE_BUCKETS);
+        if (key < q->overflow)
+            q->overflow = key;
+    }
+}
+
+static void bucket_migrate(queue_t *q) {
+    /*
+     * Moves the elements of the overflow lane that entered
+     * the window of the buckets, the lower bound is recomputed
+     * on the remaining ones.
+     */
+    uint32_t item = q->heads[QUEUE_BUCKETS];
+    q->overflow = UINT32_MAX;
+
+    while (item != QUEUE_NONE) {
+        uint32_t next = q->next[item];
+        uint_fast32_t key = queue_key(q->priorities[item]);
+
+        if (key < q->base + QUEUE_BUCKETS) {
+            bucket_unlink(q, item);
+            bucket_place(q, item, q->priorities[item]);
+        } else if (key < q->overflow) {
+            q->overflow = key;
+        }
+
+        item = next;
+    }
+}
+
+static bool bucket_push(queue_t *q, uint32_t item, queue_priority_t priority) {
+    if (q->size == 0)
+        q->base = queue_key(priority);
+
+    if (q->slots[item] == 0) {
+        bucket_place(q, item, priority);
+        q->size++;
+        return true;
+    }
+
+    if (priority >= q->priorities[item])
+        return false;
+
+    bucket_unlink(q, item);
+    bucket_place(q, item, priority);
+    return true;
+}
+
+static uint32_t bucket_pop(queue_t *q) {
+    uint_fast32_t scanned = 0;
+
+    for (;;) {
+        if (q->heads[QUEUE_BUCKETS] != QUEUE_NONE && q->overflow < q->base + QUEUE_BUCKETS)
+            bucket_migrate(q);
+
+        uint32_t item = q->heads[q->base & (QUEUE_BUCKETS - 1)];
+        if (item != QUEUE_NONE) {
+            bucket_unlink(q, item);
+            q->size--;
+            return item;
+        }
+
+        // When every bucket is empty the cursor jumps to the overflow lane.
+        if (++scanned >= QUEUE_BUCKETS) {
+            q->base = q->overflow;
+            scanned = 0;
+        } else {
+            q->base++;
+        }
+    }
+}
+
+void queue_init(queue_t *q, size_t capacity, queue_kind_t kind) {
+    q->kind = kind;
+    q->items = NULL;
+    q->next = NULL;
+    q->previous = NULL;
+    q->heads = NULL;
+    q->base = 0;
+    q->overflow = UINT32_MAX;
+    q->size = 0;
+    q->capacity = capacity;
+    q->priorities = (queue_priority_t *) PROGRAM_MALLOC(capacity * sizeof(queue_priority_t));
+    q->slots = (uint32_t *) PROGRAM_CALLOC(capacity, sizeof(uint32_t));
+
+    if (kind == QUEUE_HEAP) {
+        q->items = (uint32_t *) PROGRAM_MALLOC(capacity * sizeof(uint32_t));
+    } else {
+        q->next = (uint32_t *) PROGRAM_MALLOC(capacity * sizeof(uint32_t));
+        q->previous = (uint32_t *) PROGRAM_MALLOC(capacity * sizeof(uint32_t));
+        q->heads = (uint32_t *) PROGRAM_MALLOC((QUEUE_BUCKETS + 1) * sizeof(uint32_t));
+        memset(q->heads, 0xFF, (QUEUE_BUCKETS + 1) * sizeof(uint32_t));
+    }
+}
+
+void queue_free(queue_t q) {
+    PROGRAM_FREE(q.priorities);
+    PROGRAM_FREE(q.slots);
+
+    if (q.kind == QUEUE_HEAP) {
+        PROGRAM_FREE(q.items);
+    } else {
+        PROGRAM_FREE(q.next);
+        PROGRAM_FREE(q.previous);
+        PROGRAM_FREE(q.heads);
+    }
+}
+
+void queue_clear(queue_t *q) {
+    if (q->kind == QUEUE_HEAP) {
+        for (size_t i = 0; i < q->size; ++i)
+            q->slots[q->items[i]] = 0;
+    } else if (q->size > 0) {
+        for (uint32_t bucket = 0; bucket <= QUEUE_BUCKETS; ++bucket) {
+            for (uint32_t item = q->heads[bucket]; item != QUEUE_NONE; item = q->next[item])
+                q->slots[item] = 0;
+
+            q->heads[bucket] = QUEUE_NONE;
+        }
+
+        q->overflow = UINT32_MAX;
+    }
+
+    q->size = 0;
+}
+
+bool queue_empty(const queue_t *q) {
+    return q->size == 0;
+}
+
+bool queue_contains(const queue_t *q, uint32_t item) {
+    return q->slots[item] != 0;
+}
+
+queue_priority_t queue_priority(const queue_t *q, uint32_t item) {
+    if (q->kind == QUEUE_HEAP)
+        return q->priorities[q->slots[item] - 1];
+
+    return q->priorities[item];
+}
+
+bool queue_push(queue_t *q, uint32_t item, queue_priority_t priority) {
+    if (q->kind == QUEUE_HEAP)
+        return heap_push(q, item, priority);
+
+    return bucket_push(q, item, priority);
+}
+
+uint32_t queue_pop(queue_t *q) {
+    if (q->kind == QUEUE_HEAP)
+        return heap_pop(q);
+
+    return bucket_pop(q);
+}
@@ -0,0 +1,205 @@
+/**
+ * @file queue.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the priority queue used by the solvers
+ *
+ * These file contains an indexed priority queue with two backends,
+ * a binary heap and a bucket queue. Every element of the queue is
+ * identified by an index (usually the linearized position of a block
+ * inside the maze) so the priority of an element already queued can
+ * be lowered without searching it.
+ */
+
+#ifndef SNAKE_QUEUE_H
+#define SNAKE_QUEUE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../configuration.h"
+#include "../rpmalloc/rpmalloc.h"
+
+/**
+ * @brief Priority assigned to an element of the queue.
+ *
+ * Lower priorities are extracted first.
+ *
+ * @see queue_compose_priority
+ */
+typedef uint_fast64_t queue_priority_t;
+
+/**
+ * @details How many low bits of a queue_priority_t
+ * are used to break ties between equal keys.
+ */
+#define QUEUE_TIE_BITS 32
+
+/**
+ * @brief Composes a priority from a key and a preference.
+ *
+ * Elements with a lower @p key are extracted first,
+ * among elements with the same key the ones with a higher
+ * @p preference are extracted first.
+ *
+ * @param key Main key of the element
+ * @param preference Tie-breaker of the element, at most 32 bits
+ * @return The composed queue_priority_t
+ */
+#define queue_compose_priority(key, preference) \
+    (((queue_priority_t) (key) << QUEUE_TIE_BITS) | (UINT32_MAX - (uint32_t) (preference)))
+
+/**
+ * @details How many buckets are used by the bucket queue,
+ * must be a power of 2.
+ *
+ * Keys farther than QUEUE_BUCKETS from the lowest queued
+ * key are moved in the overflow lane.
+ */
+#define QUEUE_BUCKETS 1024
+
+/**
+ * @details Index used to terminate the lists of the bucket queue.
+ */
+#define QUEUE_NONE UINT32_MAX
+
+/**
+ * @brief Backends of the queue.
+ *
+ * QUEUE_HEAP is a binary min-heap, push and pop run in O(log n)
+ * and priorities are compared entirely.
+ *
+ * QUEUE_BUCKET is a bucket queue (Dial), push and pop run in O(1)
+ * as the elements are stored in a circular array of buckets,
+ * one for every key. Keys too far from the lowest key are kept
+ * in an overflow lane and moved into the buckets when these are empty.
+ * Inside a bucket the last pushed element is extracted first,
+ * the preference of queue_compose_priority is ignored.
+ *
+ * @warning The bucket queue requires monotone keys: an element
+ * pushed with a key lower than the last extracted one, or than the
+ * first one pushed in the empty queue, is queued as if it had that key.
+ */
+typedef enum queue_kind {
+    QUEUE_HEAP = 0, QUEUE_BUCKET = 1
+} queue_kind_t;
+
+/**
+ * @brief Struct that represents an indexed priority queue.
+ *
+ * A slot of 0 means that the element is not queued.
+ *
+ * For QUEUE_HEAP the indexes of the queued elements are stored in heap
+ * order with their priorities, while @c slots maps every possible index
+ * to its position inside the heap, the element is stored at <tt>slot - 1</tt>.
+ *
+ * For QUEUE_BUCKET every bucket is a doubly linked list of indexes,
+ * @c slots maps every possible index to its bucket (plus one) and the
+ * priorities are stored by index. The overflow lane is the last list.
+ */
+typedef struct queue {
+    queue_kind_t kind; /**< Backend of the queue */
+    uint32_t *items; /**< Heap ordered indexes of the queued elements (heap only) */
+    queue_priority_t *priorities; /**< Priorities by heap position (heap) or by index (bucket) */
+    uint32_t *slots; /**< Heap position or bucket (plus one) of every index, 0 if not queued */
+    uint32_t *next; /**< Next index in the same bucket (bucket only) */
+    uint32_t *previous; /**< Previous index in the same bucket (bucket only) */
+    uint32_t *heads; /**< First index of every bucket and of the overflow lane (bucket only) */
+    uint_fast32_t base; /**< Key of the bucket under the cursor (bucket only) */
+    uint_fast32_t overflow; /**< Lower bound of the keys in the overflow lane (bucket only) */
+    size_t size; /**< How many elements are queued */
+    size_t capacity; /**< How many different indexes the queue can hold */
+} queue_t;
+
+/**
+ * @brief Allocates space for the queue
+ *
+ * Allocates the storage of the selected backend so that
+ * every index in the range [0, @p capacity) can be queued.
+ *
+ * Remember after using the queue to free the allocated
+ * memory by calling queue_free.
+ *
+ * @param q Pointer to the queue object
+ * @param capacity How many different indexes can be queued
+ * @param kind Backend of the queue
+ */
+void queue_init(queue_t *q, size_t capacity, queue_kind_t kind)__attribute__((nonnull));
+
+/**
+ * @brief Frees the queue used space.
+ *
+ * @param q Queue that needs to be deallocated
+ * @warning queue_init must be called before calling this function.
+ */
+void queue_free(queue_t q);
+
+/**
+ * @brief Removes every element from the queue
+ *
+ * Only the slots of the elements still queued are reset,
+ * so the cost depends on the queue size (and on the buckets)
+ * and not on its capacity.
+ *
+ * @param q Pointer to the queue object
+ */
+void queue_clear(queue_t *q)__attribute__((nonnull));
+
+/**
+ * @brief Checks if the queue has no elements.
+ *
+ * @param q Queue to be checked
+ * @return True if the queue is empty.
+ */
+bool queue_empty(const queue_t *q)__attribute__((nonnull));
+
+/**
+ * @brief Checks if an index is currently queued.
+ *
+ * @param q Queue to be checked
+ * @param item Index of the element
+ * @return True if @p item is inside the queue.
+ */
+bool queue_contains(const queue_t *q, uint32_t item)__attribute__((nonnull));
+
+/**
+ * @brief Returns the priority of a queued element.
+ *
+ * @param q Queue where the element is stored
+ * @param item Index of the element
+ * @return The priority of @p item.
+ * @warning The element must be queued, see queue_contains.
+ */
+queue_priority_t queue_priority(const queue_t *q, uint32_t item)__attribute__((nonnull));
+
+/**
+ * @brief Inserts an element or lowers its priority.
+ *
+ * If @p item is not queued it is inserted with the
+ * provided priority, otherwise its priority is replaced
+ * only when the new one is lower (decrease-key).
+ *
+ * Runs in O(log n) with QUEUE_HEAP and O(1) with QUEUE_BUCKET.
+ *
+ * @param q Pointer to the queue object
+ * @param item Index of the element
+ * @param priority Priority of the element
+ * @return True if the queue has been changed.
+ */
+bool queue_push(queue_t *q, uint32_t item, queue_priority_t priority)__attribute__((nonnull));
+
+/**
+ * @brief Extracts the element with the lowest priority.
+ *
+ * Runs in O(log n) with QUEUE_HEAP and in amortized O(1)
+ * with QUEUE_BUCKET.
+ *
+ * @param q Pointer to the queue object
+ * @return The index of the extracted element.
+ * @warning The queue must not be empty.
+ */
+uint32_t queue_pop(queue_t *q)__attribute__((nonnull));
+
+#endif //SNAKE_QUEUE_H
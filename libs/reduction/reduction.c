@@ -0,0 +1,66 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "reduction.h"
+
+static bool reduction_is_dead_end(maze_t maze, location_t l) {
+    maze_data_t block = *core_get_block_location(maze, l);
+
+    if (block == SNAKE_WALL_CHAR || block == SNAKE_COIN_CHAR || block == SNAKE_DRILL_CHAR)
+        return false;
+
+    if (core_compare_locations(l, maze.start) || core_compare_locations(l, maze.end))
+        return false;
+
+    uint_fast8_t open = 0;
+    for (uint_fast8_t i = 1; i < 5; ++i) {
+        location_t neighbor = core_get_neighbor(l, i, 1);
+
+        if (core_is_in_bounds(maze, neighbor) && *core_get_block_location(maze, neighbor) != SNAKE_WALL_CHAR)
+            open++;
+    }
+
+    return open <= 1;
+}
+
+size_t reduction_fill_dead_ends(maze_t maze) {
+    size_t cells = (size_t) maze.width * maze.height, filled = 0;
+
+    for (size_t i = 0; i < cells; ++i) {
+        if (maze.blocks[i] == SNAKE_DRILL_CHAR)
+            return 0;
+    }
+
+    cvector_vector_type(location_t) stack = NULL;
+    for (size_t i = 0; i < cells; ++i) {
+        location_t l = {i % maze.width, i / maze.width};
+
+        if (reduction_is_dead_end(maze, l))
+            cvector_push_back(stack, l);
+    }
+
+    /*
+     * Every filled block can only turn its single open
+     * neighbor in a dead end, so only that one is tested again.
+     */
+    while (!cvector_empty(stack)) {
+        location_t current = cvector_pop_return(stack);
+
+        if (!reduction_is_dead_end(maze, current))
+            continue;
+
+        core_set_block(maze, current, SNAKE_WALL_CHAR);
+        filled++;
+
+        for (uint_fast8_t i = 1; i < 5; ++i) {
+            location_t neighbor = core_get_neighbor(current, i, 1);
+
+            if (core_is_in_bounds(maze, neighbor) && reduction_is_dead_end(maze, neighbor))
+                cvector_push_back(stack, neighbor);
+        }
+    }
+
+    cvector_free(stack);
+    return filled;
+}
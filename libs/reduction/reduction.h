@@ -0,0 +1,40 @@
+/**
+ * @file reduction.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the reductions of a maze
+ *
+ * These file contains functions that remove from a maze the
+ * blocks that no path worth walking can use, so that the solvers
+ * ran on it expand fewer paths. The maze changed is a copy used
+ * only by the solvers.
+ */
+
+#ifndef SNAKE_REDUCTION_H
+#define SNAKE_REDUCTION_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../configuration.h"
+#include "../core/core.h"
+
+/**
+ * @brief Fills the dead ends of a maze
+ *
+ * A dead end is a block with at most one neighbor that is not
+ * a wall. When it's not the start, the end, a coin or a drill a
+ * path that enters it can only come back, so it's replaced by a wall.
+ * Filling a block can turn its neighbor in a dead end, the blocks
+ * are filled until no dead end is left, in O(width * height).
+ *
+ * A filled block would be a wall that a drill can cross, so when
+ * the maze has drills nothing is filled.
+ *
+ * @param maze Maze where the dead ends are filled, usually a copy used by the solvers
+ * @return How many blocks have been filled.
+ */
+size_t reduction_fill_dead_ends(maze_t maze);
+
+#endif //SNAKE_REDUCTION_H
@@ -4,6 +4,9 @@
 
 #include "runtime.h"
 
+static size_t runtime_beam_width = PROGRAM_SOLVER_BEAM_WIDTH;
+static solver_beam_rank_t runtime_beam_rank = PROGRAM_SOLVER_BEAM_RANK;
+
 static void runtime_truncate_body(maze_t m, body_t body, size_t index) {
     register size_t j;
     for (j = 0; j < index; ++j) {
@@ -35,20 +38,117 @@ static void runtime_shift_player(maze_t maze, player_t p) {
     core_set_block(maze, p.position, SNAKE_PLAYER_CHAR);
 }
 
+static void runtime_improved(path_t path, int_fast32_t score, void *context) {
+    unsigned long mili_seconds = (unsigned long) ((solver_now() - *(double *) context) * 1000);
+
+    char value[12], elapsed[12];
+    sprintf(value, "%ld", (long) score);
+    sprintf(elapsed, "%lu", mili_seconds);
+
+    coutput_string(OUTPUT_SPACER "Found a path with score ", 141);
+    coutput_string(value, 36);
+    coutput_string(" after ", 141);
+    coutput_string(elapsed, 36);
+    coutput_string(" milliseconds\n", 141);
+}
+
+static void runtime_reduce(maze_t view) {
+    size_t filled = PROGRAM_SOLVER_FILL_DEAD_ENDS ? reduction_fill_dead_ends(view) : 0;
+
+    if (filled == 0)
+        return;
+
+    char value[21];
+    sprintf(value, "%zu", filled);
+
+    coutput_string(OUTPUT_SPACER "Filled ", 141);
+    coutput_string(value, 36);
+    coutput_string(" dead end blocks\n", 141);
+}
+
+static path_t runtime_portfolio(maze_t maze, double deadline) {
+    portfolio_result_t result = portfolio_execute(maze, PROGRAM_SOLVER_PORTFOLIO, deadline);
+
+    for (size_t i = 0; i < PORTFOLIO_STRATEGIES; ++i) {
+        portfolio_entry_t entry = result.entries[i];
+
+        if (!entry.ran)
+            continue;
+
+        char line[64];
+        if (entry.path)
+            sprintf(line, "%-8s score %ld in %lu milliseconds\n", portfolio_name(i), (long) entry.score,
+                    (unsigned long) (entry.seconds * 1000));
+        else
+            sprintf(line, "%-8s no path in %lu milliseconds\n", portfolio_name(i),
+                    (unsigned long) (entry.seconds * 1000));
+
+        coutput_string(OUTPUT_SPACER, 141);
+        coutput_string(line, result.path && i == result.winner ? 36 : 141);
+    }
+
+    if (result.path) {
+        coutput_string(OUTPUT_SPACER "Won by ", 141);
+        coutput_string((char *) portfolio_name(result.winner), 36);
+        coutput_string(result.proven ? ", proven to be the best path\n" : "\n", 141);
+
+        // The path of the winner is kept, the others are freed.
+        result.entries[result.winner].path = NULL;
+    }
+
+    portfolio_free(result);
+    return result.path;
+}
+
 static void runtime_ai(maze_t maze){
     path_t path;
-    clock_t mili_seconds;
-    clock_t before = clock();
+    unsigned long mili_seconds;
+    double before = solver_now();
+
+    /*
+     * The solvers run on a copy of the maze without the coins
+     * that can never be collected and without the dead ends,
+     * the maze is printed as it is.
+     */
+    components_t components;
+    components_init(&components, maze);
+
+    maze_t view = core_duplicate_maze(maze);
+    components_prune(&components, view);
+    components_free(components);
+    runtime_reduce(view);
 
     location_t current = maze.start;
-#if PROGRAM_SOLVER_RUN_SIMPLE == false
-    path = solver_execute_full(maze);
+#if PROGRAM_SOLVER_RUN_TOUR == true
+    path = tour_execute(view);
+#elif PROGRAM_SOLVER_RUN_SIMPLE == false
+    if (PROGRAM_SOLVER_TREE && (path = tree_execute(view)) != NULL) {
+        coutput_string(OUTPUT_SPACER "Solved as a tree\n", 141);
+    } else if (PROGRAM_SOLVER_PORTFOLIO != 0) {
+        path = runtime_portfolio(view, before + PROGRAM_SOLVER_TIMEOUT);
+    } else if (runtime_beam_width > 0) {
+        solver_control_t control = {before + PROGRAM_SOLVER_TIMEOUT};
+        path = solver_execute_beam(view, runtime_beam_width, runtime_beam_rank, &control, NULL);
+    } else if (PROGRAM_SOLVER_THREADS > 1) {
+        solver_control_t control = {before + PROGRAM_SOLVER_TIMEOUT, PROGRAM_SOLVER_FULL_PRECISION};
+        path = solver_execute_parallel(view, PROGRAM_SOLVER_THREADS, &control, NULL);
+    } else {
+        path = solver_execute_anytime(view, before + PROGRAM_SOLVER_TIMEOUT, runtime_improved, &before, NULL);
+    }
+
+    if (PROGRAM_SOLVER_IMPROVE_TIMEOUT > 0)
+        path = tour_refine(view, path, solver_now() + PROGRAM_SOLVER_IMPROVE_TIMEOUT);
 #else
-    path = solver_execute_astar(maze, maze.start, maze.end, NULL, true);
+    path = solver_execute_bidirectional(view, view.start, view.end);
 #endif
 
-    clock_t difference = clock() - before;
-    mili_seconds = difference * 1000 / CLOCKS_PER_SEC;
+    core_free_maze(view);
+
+    // The score printed is the one the game gives to the path.
+    if (path)
+        solver_collect(maze, path);
+
+    mili_seconds = (unsigned long) ((solver_now() - before) * 1000);
 
     path_t iterator;
     cvector_for_each_in(iterator, path) {
@@ -58,10 +158,8 @@ static void runtime_ai(maze_t maze){
     output_string(OUTPUT_LINE);
     core_print_colored_maze(maze);
     if (!cvector_empty(path) && cvector_size(path) > 2) {
-        int_fast16_t size = (int_fast16_t) cvector_size(path);
-
         char score[12];
-        sprintf(score, "%lu", (1000 - size + 10 * cvector_last(path)->coins) + 2);
+        sprintf(score, "%ld", (long) solver_score(path));
 
         coutput_string(OUTPUT_LINE OUTPUT_SPACER "Score: ", 141);
         coutput_string(score, 36);
@@ -90,7 +188,7 @@ static void runtime_ai(maze_t maze){
     } else
         coutput_string(OUTPUT_LINE OUTPUT_SPACER "No path found!\n", 141);
 
-    char seconds[12], miliseconds[5];
+    char seconds[21], miliseconds[5];
     sprintf(seconds, "%lu", mili_seconds / 1000);
     sprintf(miliseconds, "%lu", mili_seconds % 1000);
     coutput_string(OUTPUT_SPACER "Calculated in ", 141);
@@ -185,6 +283,11 @@ static void runtime_interactive(maze_t maze) {
     cvector_free(snake.body);
 }
 
+void runtime_set_beam(size_t width, solver_beam_rank_t rank) {
+    runtime_beam_width = width;
+    runtime_beam_rank = rank;
+}
+
 void runtime_execute_mode(game_mode_t mode, maze_t *maze, bool generate) {
     switch (mode) {
         case MODE_EXIT:
@@ -205,7 +308,7 @@ void runtime_execute_mode(game_mode_t mode, maze_t *maze, bool generate) {
             break;
         case MODE_TEST:
             generator_create(maze);
-            path_t result = solver_execute_astar(*maze, maze->start, maze->end, NULL, true);
+            path_t result = solver_execute_bidirectional(*maze, maze->start, maze->end);
             for (int i = 0; i < cvector_size(result); i++)
                 core_set_block(*maze, result[i], SNAKE_PATH_CHAR);
 
@@ -17,6 +17,11 @@
 #include "../generator/generator.h"
 #include "../vector/cvector.h"
 #include "../solver/solver.h"
+#include "../tour/tour.h"
+#include "../portfolio/portfolio.h"
+#include "../components/components.h"
+#include "../reduction/reduction.h"
+#include "../tree/tree.h"
 
 /**
  * @brief Typedef to create a vector of locations
@@ -55,6 +60,15 @@ typedef enum game_mode {
     MODE_TEST = 4, /**< Mode test, used for big tests. */
 } game_mode_t;
 
+/**
+ * @brief Makes the ai mode run the beam search
+ *
+ * @see solver_execute_beam
+ * @param width Paths kept after every step, 0 runs the full solver
+ * @param rank Ranking of the paths
+ */
+void runtime_set_beam(size_t width, solver_beam_rank_t rank);
+
 /**
  * @brief Runs the selected mode, on the passed maze
  *
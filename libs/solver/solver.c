@@ -6,49 +6,198 @@
 
 #include "solver.h"
 
-static void free_path(void *pointer) {
-    cvector_free(pointer);
-}
-
 static int_fast16_t calculate_score(uint_fast16_t coins, uint_fast16_t steps) {
     return (int_fast16_t) (1000 - steps + 10 * coins);
 }
 
-static maze_data_t calculate_distance(location_t val_1, location_t val_2) {
-    maze_data_t dif_x = abs(val_2.x - val_1.x);
-    maze_data_t dif_y = abs(val_2.y - val_1.y);
+static uint_fast16_t calculate_distance(location_t val_1, location_t val_2) {
+    // The sum of the differences may not fit in a maze_data_t.
+    uint_fast16_t dif_x = abs(val_2.x - val_1.x);
+    uint_fast16_t dif_y = abs(val_2.y - val_1.y);
     return dif_x + dif_y;
 }
 
+
 static uint_fast16_t calculate_cost(maze_t m, location_t val_1, location_t val_2) {
     maze_data_t bs = *core_get_block_location(m, val_1);
 
     if (bs == SNAKE_DANGER_CHAR)
-        return 10000;
+        return SOLVER_DANGER_PENALTY;
 
     return calculate_distance(val_1, val_2);
 }
 
-static bool compare_paths(path_t p_1, path_t p_2) {
-    return p_1 == p_2;
+static uint_fast32_t calculate_step(maze_t m, location_t l) {
+    if (*core_get_block_location(m, l) == SNAKE_DANGER_CHAR)
+        return 1 + SOLVER_DANGER_PENALTY;
+
+    return 1;
+}
+
+static uint_fast32_t calculate_position_cost(solver_order_t order, maze_t m, location_t l, location_t end) {
+    if (order == SOLVER_ORDER_ASTAR)
+        return calculate_step(m, l);
+
+    return calculate_cost(m, l, end);
+}
+
+static queue_priority_t calculate_priority(solver_order_t order, location_t l, location_t end) {
+    if (order == SOLVER_ORDER_ASTAR) {
+        // f = g + h, on equal f the deepest location is expanded first
+        return queue_compose_priority(l.accumulation_cost + calculate_distance(l, end), l.accumulation_cost);
+    }
+
+    return queue_compose_priority(l.accumulation_cost, 0);
+}
+
+static uint32_t calculate_index(maze_t m, location_t l) {
+    return (uint32_t) l.x + (uint32_t) l.y * m.width;
+}
+
+static uint32_t calculate_state(maze_t m, location_t l) {
+    return calculate_index(m, l) * SOLVER_LAYERS + (uint32_t) l.drills;
+}
+
+static void solver_table_init(solver_table_t *table, maze_t maze) {
+    table->size = (uint32_t) maze.width * maze.height * SOLVER_LAYERS;
+    table->cells = (solver_cell_t *) PROGRAM_CALLOC(table->size, sizeof(solver_cell_t));
+    table->generation = 0;
+}
+
+static void solver_table_free(solver_table_t table) {
+    PROGRAM_FREE(table.cells);
+}
+
+static void solver_table_next_generation(solver_table_t *table) {
+    /*
+     * Records written by previous searches are recognized by their
+     * stamp, the table is wiped only when the stamp wraps around.
+     */
+    if (++table->generation == 0) {
+        memset(table->cells, 0, table->size * sizeof(solver_cell_t));
+        table->generation = 1;
+    }
+}
+
+static solver_cell_t *solver_table_touch(solver_table_t *table, uint32_t index) {
+    solver_cell_t *cell = &table->cells[index];
+
+    if (cell->generation != table->generation) {
+        cell->generation = table->generation;
+        cell->closed = false;
+        cell->cost = UINT32_MAX;
+    }
+
+    return cell;
+}
+
+static void solver_table_store(solver_table_t *table, maze_t maze, location_t l, uint32_t parent) {
+    solver_cell_t *cell = solver_table_touch(table, calculate_state(maze, l));
+
+    cell->parent = parent;
+    cell->cost = (uint32_t) l.accumulation_cost;
+    cell->comes_from = l.comes_from;
+    cell->dangers = l.dangers;
+}
+
+static bool solver_table_dominated(solver_table_t *table, uint32_t state, uint32_t cost, uint32_t drills) {
+    /*
+     * A state is useless when the same block has already been
+     * reached with at least as many drills at an equal or lower cost.
+     * Only the layers up to the most drills held by the search are checked.
+     */
+    uint32_t last = state - state % SOLVER_LAYERS + drills;
+
+    for (uint32_t other = state; other <= last; ++other) {
+        const solver_cell_t *cell = &table->cells[other];
+
+        if (cell->generation == table->generation && cell->cost <= cost)
+            return true;
+    }
+
+    return false;
+}
+
+static bool solver_table_visited(const solver_table_t *table, uint32_t state, uint32_t position) {
+    for (; state != SOLVER_NO_PARENT; state = table->cells[state].parent) {
+        if (state / SOLVER_LAYERS == position)
+            return true;
+    }
+
+    return false;
+}
+
+static location_t solver_table_location(const solver_workspace_t *w, maze_t maze, uint32_t state,
+                                        location_t start, location_t end) {
+    const solver_cell_t *cell = &w->table.cells[state];
+    uint32_t index = state / SOLVER_LAYERS;
+    location_t l = start;
+
+    l.x = index % maze.width;
+    l.y = index / maze.width;
+    l.comes_from = cell->comes_from;
+    l.position_cost = calculate_position_cost(w->order, maze, l, end);
+    l.accumulation_cost = cell->cost;
+    l.drills = state % SOLVER_LAYERS;
+    l.dangers = cell->dangers;
+
+    return l;
+}
+
+static void complete_path(maze_t maze, path_t path, size_t from) {
+    /*
+     * Fills every location after @p from with the move, the costs,
+     * the dangers and the drills obtained by walking the path.
+     */
+    for (size_t i = from; i < cvector_size(path); ++i) {
+        location_t *l = &path[i];
+        const location_t *previous = &path[i - 1];
+        maze_data_t block = *core_get_block_location(maze, *l);
+
+        l->comes_from = core_get_transition(*l, *previous);
+        l->position_cost = calculate_step(maze, *l);
+        l->accumulation_cost = previous->accumulation_cost + l->position_cost;
+        l->dangers = previous->dangers + (block == SNAKE_DANGER_CHAR);
+        l->drills = previous->drills;
+
+        if (block == SNAKE_DRILL_CHAR)
+            l->drills = l->drills + 3 > SOLVER_MAX_DRILLS ? SOLVER_MAX_DRILLS : l->drills + 3;
+        else if (block == SNAKE_WALL_CHAR && l->drills > 0)
+            l->drills--;
+    }
+}
+
+static void mark_path(maze_t maze, bitmap_t mask, path_t path, size_t from, size_t to, bool value) {
+    for (size_t i = from; i < to; ++i) {
+        uint32_t index = calculate_index(maze, path[i]);
+
+        if (value)
+            bitmap_set(mask, index);
+        else
+            bitmap_reset(mask, index);
+    }
 }
 
-static bool path_overlay(path_t first, path_t second) {
+static bool path_overlay(maze_t maze, bitmap_t mask, path_t first, path_t second) {
     bool overlay = false;
 
-    for (int j = 1; j < cvector_size(first) - 1 && !overlay; ++j) {
-        for (int k = 1; k < cvector_size(second) - 1 && !overlay; ++k) {
-            if (core_compare_locations(first[j], second[k])) {
-                overlay = true;
-            }
+    if (cvector_size(first) < 3 || cvector_size(second) < 3)
+        return false;
+
+    // Only the inner blocks of the paths are compared.
+    mark_path(maze, mask, first, 1, cvector_size(first) - 1, true);
+    for (size_t k = 1; k < cvector_size(second) - 1 && !overlay; ++k) {
+        if (bitmap_test(mask, calculate_index(maze, second[k]))) {
+            overlay = true;
         }
     }
+    mark_path(maze, mask, first, 1, cvector_size(first) - 1, false);
 
     return overlay;
 }
 
-static bool test_coin_estimation(path_t start, path_t end, location_t coin) {
-    bool overlay = path_overlay(start, end);
+static bool test_coin_estimation(maze_t maze, bitmap_t mask, path_t start, path_t end, location_t coin) {
+    bool overlay = path_overlay(maze, mask, start, end);
     bool has_end_path =
             !cvector_empty(end) && core_compare_locations(*cvector_last(end), coin);
     bool has_start_path =
@@ -59,427 +208,2031 @@ static bool test_coin_estimation(path_t start, path_t end, location_t coin) {
     return overlay || has_end_took_dangers || has_start_took_dangers || !has_end_path || !has_start_path;
 }
 
-static bool solver_execute_dfs(maze_t maze, location_t start, location_t end) {
-    path_t visited = NULL;
-    path_t stack = NULL;
+double solver_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
 
-    cvector_push_back(stack, start);
-    while (cvector_size(stack) > 0) {
-        location_t current = cvector_pop_return(stack);
+bool solver_expired(const solver_control_t *control) {
+    if (!control)
+        return false;
 
-        if (core_compare_locations(current, end)) {
-            cvector_free(visited);
-            cvector_free(stack);
-            return true;
-        }
+    if (!PROGRAM_SOLVER_IGNORE_TIMEOUT && solver_now() >= control->deadline)
+        return true;
 
-        path_t iterator = NULL;
-        cvector_reverse_for_each_in(iterator, visited) {
-                if (core_compare_locations(*iterator, current))
-                    break;
+    return control->cancel && __atomic_load_n(control->cancel, __ATOMIC_ACQUIRE);
+}
+
+static void collect_replay(maze_t maze, path_t path, solver_visit_t *visits, uint32_t generation) {
+    /*
+     * Replays the path with the rules of the game. Every block changes
+     * only the first time it's walked, then it's empty. The body of the
+     * snake holds a block for every coin, so it covers the blocks walked
+     * in the last moves: moving on one of them cuts the body there.
+     */
+    uint_fast16_t coins = 0, drills = 0, dangers = 0;
+    uint32_t moves = 0;
+    for (size_t i = 0; i < cvector_size(path); ++i) {
+        uint32_t position = calculate_index(maze, path[i]);
+        maze_data_t block = maze.blocks[position];
+
+        // A repeated location is not a move.
+        bool moved = i > 0 && !core_compare_locations(path[i - 1], path[i]);
+
+        if (moved) {
+            if (visits[position].generation != generation) {
+                switch (block) {
+                    case SNAKE_COIN_CHAR:
+                        coins++;
+                        break;
+                    case SNAKE_DRILL_CHAR:
+                        drills += 3;
+                        break;
+                    case SNAKE_WALL_CHAR:
+                        drills--;
+                        break;
+                    case SNAKE_DANGER_CHAR:
+                        // The body keeps its longer half.
+                        coins -= coins / 2;
+                        dangers++;
+                        break;
+                    default:
+                        break;
+                }
+            } else if (visits[position].move + coins >= moves) {
+                // Only the blocks walked after this one are kept.
+                coins = moves - visits[position].move;
             }
 
-        if (iterator == cvector_begin(visited)) {
-            cvector_push_back(visited, current);
+            moves++;
+        }
 
-            for (int i = 1; i < 5; ++i) {
-                location_t neighbor = core_get_neighbor(current, i, 1);
+        visits[position].generation = generation;
+        visits[position].move = moves;
+        path[i].coins = coins;
+        path[i].drills = drills;
+        path[i].dangers = dangers;
+    }
+}
 
-                if (!core_is_in_bounds(maze, neighbor)) {
-                    continue;
-                }
+void solver_collect(maze_t maze, path_t path) {
+    solver_visit_t *visits = (solver_visit_t *) PROGRAM_CALLOC((size_t) maze.width * maze.height,
+                                                               sizeof(solver_visit_t));
 
-                maze_data_t neighbor_data = *core_get_block_location(maze, neighbor);
-                if (neighbor_data == SNAKE_WALL_CHAR) {
-                    if (neighbor.drills > 0) {
-                        neighbor.drills--;
-                    } else {
-                        cvector_push_back(visited, neighbor);
-                        continue;
-                    }
-                }
+    collect_replay(maze, path, visits, 1);
+    PROGRAM_FREE(visits);
+}
 
-                cvector_push_back(stack, neighbor);
-            }
-        }
+void solver_collect_with(solver_workspace_t *w, maze_t maze, path_t path) {
+    // As the table of the a*, the visits are wiped only when the stamp wraps around.
+    if (++w->replay == 0) {
+        memset(w->visits, 0, (size_t) maze.width * maze.height * sizeof(solver_visit_t));
+        w->replay = 1;
     }
 
-    cvector_free(visited);
-    cvector_free(stack);
-
-    return false;
+    collect_replay(maze, path, w->visits, w->replay);
 }
 
-static int estimate_coins(maze_t maze) {
-    // Trying to estimate the points
-    // that could be reached without affecting
-    // the score
+int_fast32_t solver_score(path_t path) {
+    if (cvector_empty(path))
+        return INT_FAST32_MIN;
 
-    path_t points = NULL;
+    int_fast32_t moves = 0;
+    for (size_t i = 1; i < cvector_size(path); ++i)
+        moves += !core_compare_locations(path[i - 1], path[i]);
 
-    for (int i = 0; i < maze.width * maze.height; ++i) {
-        if (*core_get_block(maze, i % maze.width, i / maze.width) == SNAKE_COIN_CHAR) {
-            location_t current = {i % maze.width, i / maze.width};
-            /*
-             * Dfs algorithm runs faster than a* as it uses fewer vectors,
-             * and fewer cycles.
-             */
-            if (solver_execute_dfs(maze, maze.end, current)) {
-                cvector_push_back(points, current);
-            } else {
-                /*
-                 * We run a* only when dfs is unable to find a path.
-                 */
-                path_t p = solver_execute_astar(maze, maze.start, current, NULL, true);
+    return 1000 - moves + 10 * (int_fast32_t) cvector_last(path)->coins;
+}
 
-                if (cvector_size(p) > 0)
-                    cvector_push_back(points, current);
+size_t solver_execute_field(maze_t maze, uint32_t origin, uint32_t avoid, bool dangers, uint32_t *parents,
+                            uint32_t *distances, uint32_t *queue, uint8_t *empty) {
+    size_t cells = (size_t) maze.width * maze.height, head = 0, tail = 0;
 
-                cvector_free(p);
+    // The parents mark the reached blocks when given, the distances otherwise.
+    uint32_t *reached = parents ? parents : distances;
 
-            }
-        }
+    if (parents) {
+        memset(parents, 0xFF, cells * sizeof(uint32_t));
+        parents[origin] = origin;
     }
 
-    int size = cvector_size(points);
-    for (int i = 0; i < cvector_size(points); ++i) {
-        location_t current_point = points[i];
+    if (distances) {
+        memset(distances, 0xFF, cells * sizeof(uint32_t));
+        distances[origin] = 0;
+    }
 
-        path_t end_to_point = solver_execute_astar(maze, maze.end, current_point, NULL, true);
-        path_t start_to_point = solver_execute_astar(maze, maze.start, current_point, end_to_point, true);
-        bool needs_verify = test_coin_estimation(start_to_point, end_to_point, current_point);
+    if (empty)
+        empty[origin] = true;
 
-        cvector_free(start_to_point);
-        cvector_free(end_to_point);
+    queue[tail++] = origin;
 
-        if (needs_verify) {
-            start_to_point = solver_execute_astar(maze, maze.start, current_point, NULL, true);
-            end_to_point = solver_execute_astar(maze, maze.end, current_point, start_to_point, true);
-            needs_verify = test_coin_estimation(start_to_point, end_to_point, current_point);
+    while (head < tail) {
+        uint32_t current = queue[head++];
+        location_t location = {current % maze.width, current / maze.width};
 
-            cvector_free(start_to_point);
-            cvector_free(end_to_point);
-        }
+        // The game ends on the end, so it can only be the last block walked.
+        if (current == avoid && current != origin)
+            continue;
 
-        if (needs_verify) {
-            size--;
-        }
-    }
+        for (uint_fast8_t i = 1; i < 5; ++i) {
+            location_t neighbor = core_get_neighbor(location, i, 1);
 
-    cvector_free(points);
-    return size;
-}
+            if (!core_is_in_bounds(maze, neighbor))
+                continue;
 
-path_t solver_execute_full(maze_t maze) {
-    location_t start = maze.start;
-    paths_t open = NULL, ended = NULL;
+            uint32_t index = calculate_index(maze, neighbor);
+            maze_data_t block = maze.blocks[index];
 
-    int_fast16_t path_score = INT16_MIN;
-    uint_fast16_t total_coins = estimate_coins(maze);
-    clock_t starting = clock(), mili_seconds;
+            if (block == SNAKE_WALL_CHAR || reached[index] != SOLVER_NO_PARENT)
+                continue;
 
-    start.accumulation_cost = 2;
-    start.drills = 0;
-    start.coins = 0;
-    start.dangers = 0;
+            if (block == SNAKE_DANGER_CHAR && !dangers && !(empty && empty[current]))
+                continue;
 
-    path_t start_placeholder = NULL; // Will be freed at the end of the function
-    cvector_push_back(start_placeholder, start);
-    cvector_push_back(open, start_placeholder);
-    while (cvector_size(open) > 0) {
-        bool added_to_end = false;
+            if (parents)
+                parents[index] = current;
 
-        clock_t estimation = clock() - starting;
-        mili_seconds = estimation * 1000 / CLOCKS_PER_SEC;
+            if (distances)
+                distances[index] = distances[current] + 1;
 
-        if (mili_seconds / 1000 >= PROGRAM_SOLVER_TIMEOUT && !PROGRAM_SOLVER_IGNORE_TIMEOUT)
-            break;
+            if (empty)
+                empty[index] = empty[current] && block != SNAKE_COIN_CHAR;
 
-        uint_fast16_t index_current = 0;
-        path_t current_path = *cvector_begin(open);
-        location_t current = *cvector_last(current_path);
+            queue[tail++] = index;
+        }
+    }
 
-        paths_t iterator = NULL;
-        cvector_for_each_in(iterator, open) {
-            location_t t = *cvector_last(*iterator);
+    return tail;
+}
 
-            // Expand paths that have the fewer steps.
-            if (t.accumulation_cost < current.accumulation_cost) {
-                current = t;
-                current_path = *iterator;
-                index_current = (uint_fast16_t) (iterator - open);
-            }
-        }
+static bool estimate_verify(solver_workspace_t *w, maze_t maze, location_t coin, path_t *start_to_point,
+                            path_t *end_to_point) {
+    /*
+     * The path used as overlay is marked once on the bitmap
+     * of the workspace, then every search tests the blocks
+     * with a single lookup. The paths reuse their storage.
+     */
+    bitmap_t mask = w->overlay;
 
-        if (current.coins >= total_coins) {
-            path_t shortest = solver_execute_astar(maze, current, maze.end, current_path, false);
-            cvector_push_vector(current_path, shortest);
+    solver_execute_astar_into(w, maze, maze.end, coin, NULL, true, end_to_point);
+    mark_path(maze, mask, *end_to_point, 0, cvector_size(*end_to_point), true);
+    solver_execute_astar_into(w, maze, maze.start, coin, &mask, true, start_to_point);
+    mark_path(maze, mask, *end_to_point, 0, cvector_size(*end_to_point), false);
 
-            if (!cvector_empty(shortest)) {
-                location_t end = *cvector_last(shortest);
+    if (!test_coin_estimation(maze, mask, *start_to_point, *end_to_point, coin))
+        return true;
 
-                end.coins = current.coins;
-                end.drills = current.drills;
-                end.dangers = current.dangers;
-                current = end;
-            }
+    solver_execute_astar_into(w, maze, maze.start, coin, NULL, true, start_to_point);
+    mark_path(maze, mask, *start_to_point, 0, cvector_size(*start_to_point), true);
+    solver_execute_astar_into(w, maze, maze.end, coin, &mask, true, end_to_point);
+    mark_path(maze, mask, *start_to_point, 0, cvector_size(*start_to_point), false);
 
-            cvector_free(shortest);
-        }
+    return !test_coin_estimation(maze, mask, *start_to_point, *end_to_point, coin);
+}
 
-        if (core_compare_locations(current, maze.end)) {
-            int_fast16_t current_score = calculate_score(current.coins, cvector_size(current_path));
+static bool estimate_detour(maze_t maze, uint32_t origin, uint32_t avoid, uint32_t coin, const uint32_t *marks,
+                            uint32_t mark, uint32_t *seen, uint32_t *queue) {
+    // Breadth-first search from origin to the coin that never enters the blocks marked with mark.
+    size_t head = 0, tail = 0;
 
-            if (current_score >= path_score) {
-                added_to_end = true;
-                cvector_push_back(ended, current_path);
-                path_score = current_score;
-            } else {
-                cvector_free(current_path);
-                cvector_erase(open, index_current);
-                continue;
-            }
+    seen[origin] = mark;
+    queue[tail++] = origin;
 
-            location_t last = *cvector_last(*cvector_last(ended));
+    while (head < tail) {
+        uint32_t current = queue[head++];
+        location_t location = {current % maze.width, current / maze.width};
 
-            // Timeout is set to 30 seconds.
-            // If we reach that timeout it means that the estimation was wrong,
-            // and we could not reach that amount of collected coins.
-            if (last.coins >= total_coins && !PROGRAM_SOLVER_FULL_PRECISION) {
-                // we found the best_path that reached our
-                // estimation
-                cvector_erase(open, index_current);
-                break;
-            }
-        }
+        if (current == coin)
+            return true;
+
+        if (current == avoid)
+            continue;
 
-        cvector_erase(open, index_current);
         for (uint_fast8_t i = 1; i < 5; ++i) {
-            // Never go back in best_path
-            if (current.comes_from == i)
-                continue;
+            location_t neighbor = core_get_neighbor(location, i, 1);
 
-            location_t neighbor = core_get_neighbor(current, i, 1);
+            if (!core_is_in_bounds(maze, neighbor))
+                continue;
 
-            path_t found = NULL;
-            cvector_for_each_in(found, current_path) {
-                if (core_compare_locations(neighbor, *found)) {
-                    break;
-                }
-            }
+            uint32_t index = calculate_index(maze, neighbor);
+            maze_data_t block = maze.blocks[index];
 
-            if (found != cvector_end(current_path))
+            if (block == SNAKE_WALL_CHAR || block == SNAKE_DANGER_CHAR || seen[index] == mark || marks[index] == mark)
                 continue;
 
-            if (!core_is_in_bounds(maze, neighbor))
-                continue;
+            seen[index] = mark;
+            queue[tail++] = index;
+        }
+    }
 
-            neighbor.drills = current.drills;
-            neighbor.accumulation_cost = current.accumulation_cost + 2;
+    return false;
+}
 
-            maze_data_t block = *core_get_block_location(maze, neighbor);
-            switch (block) {
-                case SNAKE_DANGER_CHAR:
-                    neighbor.coins /= 2;
-                    neighbor.dangers++;
-                    break;
-                case SNAKE_COIN_CHAR:
-                    neighbor.accumulation_cost -= 1;
-                    neighbor.coins += 1;
-                    break;
-                case SNAKE_DRILL_CHAR:
-                    neighbor.drills += 3;
-                    break;
-                case SNAKE_WALL_CHAR:
-                    if (neighbor.drills > 0)
-                        neighbor.drills--;
-                    else
-                        continue;
-                    break;
-                default:
-                    break;
-            }
+static int estimate_coins(solver_workspace_t *w, maze_t maze, double deadline) {
+    /*
+     * Estimates the coins that can be collected without affecting
+     * the score: a coin counts when a path from the start and one
+     * to the end reach it without dangers and without sharing any block.
+     * The path from the start can cross the dangers met before its
+     * first coin, they don't take anything.
+     *
+     * The shortest paths are read from the parents of two breadth-first
+     * searches, one from the start and one from the end, so most coins
+     * cost the length of their paths. When they share a block the second
+     * path is searched again around the first one, in both orders.
+     * These searches don't drill, so when the maze has drills the coins
+     * they can't confirm are verified with a*.
+     */
+    size_t cells = (size_t) maze.width * maze.height;
+    uint32_t start = calculate_index(maze, maze.start), end = calculate_index(maze, maze.end);
 
-            path_t new = NULL;
-            cvector_push_vector(new, current_path);
+    uint32_t *from_start = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *from_end = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *marks = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *seen = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *queue = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint8_t *empty = (uint8_t *) PROGRAM_MALLOC(cells * sizeof(uint8_t));
 
-            cvector_push_back(new, neighbor);
-            cvector_push_back(open, new);
-        }
+    solver_execute_field(maze, start, end, false, from_start, NULL, queue, empty);
+    solver_execute_field(maze, end, start, false, from_end, NULL, queue, NULL);
 
-        if (!added_to_end) {
-            cvector_free(current_path);
-        }
-    }
+    // Every coin marks its paths with its own values, so the arrays are cleared once.
+    memset(marks, 0xFF, cells * sizeof(uint32_t));
+    memset(seen, 0xFF, cells * sizeof(uint32_t));
 
-    int_fast16_t max_score = INT16_MIN;
-    paths_t current;
-    path_t best_path = NULL;
-    cvector_reverse_for_each_in(current, ended) {
-            int_fast16_t score = calculate_score(cvector_last(*current)->coins, cvector_size(*current));
-            if (score >= max_score) {
-                max_score = score;
-                best_path = *current;
-            }
-        }
+    path_t start_to_point = NULL, end_to_point = NULL;
+    bool drills = false;
+    int size = 0;
 
-    cvector_erase_element(open, best_path, compare_paths);
-    cvector_erase_element(ended, best_path, compare_paths);
-    cvector_free_each_and_free(open, free_path);
-    cvector_free_each_and_free(ended, free_path);
+    for (size_t i = 0; i < cells && !drills; ++i)
+        drills = maze.blocks[i] == SNAKE_DRILL_CHAR;
 
-    return best_path;
-}
+    for (uint32_t coin = 0; coin < cells; ++coin) {
+        if (maze.blocks[coin] != SNAKE_COIN_CHAR)
+            continue;
 
-path_t solver_execute_astar(maze_t maze, location_t start, location_t end, path_t overlay, bool go_back) {
-    location_t last_node = start;
-    bool detect_overlay = overlay && !cvector_empty(overlay);
+        // Past the deadline the coins left are not counted, the search stops anyway.
+        if (!PROGRAM_SOLVER_IGNORE_TIMEOUT && solver_now() >= deadline)
+            break;
 
-    path_t path = NULL, open = NULL, closed = NULL;
+        bool reached = from_start[coin] != SOLVER_NO_PARENT && from_end[coin] != SOLVER_NO_PARENT;
+        bool counted = false;
 
-    start.position_cost = calculate_cost(maze, start, end);
-    start.accumulation_cost = 0;
-    start.drills = 0;
-    start.dangers = 0;
+        if (reached) {
+            uint32_t forward = coin * 2, backward = coin * 2 + 1;
+            bool overlay = false;
 
+            for (uint32_t i = from_start[coin]; i != start; i = from_start[i])
+                marks[i] = forward;
 
-    /*
-     * Size of open array is maximum
-     * maze.width * maze.height
-     *
-     * maze_data_t * maze_data_t
-     * so the last index can be 65.024
-     */
+            for (uint32_t i = from_end[coin]; i != end && !overlay; i = from_end[i])
+                overlay = marks[i] == forward;
 
-    cvector_push_back(open, start);
-    while (!cvector_empty(open)) {
-        uint_fast16_t index_current = 0;
-        location_t current = *cvector_begin(open);
+            counted = !overlay || estimate_detour(maze, end, start, coin, marks, forward, seen, queue);
 
-        location_t *iterator;
-        cvector_for_each_in(iterator, open) {
-            if (iterator->accumulation_cost < current.accumulation_cost) {
-                current = *iterator;
-                index_current = (uint_fast16_t) (iterator - open);
+            if (!counted) {
+                for (uint32_t i = from_end[coin]; i != end; i = from_end[i])
+                    marks[i] = backward;
+
+                counted = estimate_detour(maze, start, end, coin, marks, backward, seen, queue);
             }
         }
 
-        if (core_compare_locations(current, end)) {
-            last_node = current;
-            break;
+        // Without drills a* can't find what the breadth-first searches missed.
+        if (!counted && drills) {
+            location_t location = {coin % maze.width, coin / maze.width};
+            counted = estimate_verify(w, maze, location, &start_to_point, &end_to_point);
         }
 
-        cvector_push_back(closed, current);
-        cvector_erase(open, index_current);
-        for (uint_fast8_t i = 1; i < 5; ++i) {
-            if (current.comes_from == i && !go_back)
-                continue;
+        size += counted;
+    }
 
-            location_t neighbor = core_get_neighbor(current, i, 1);
+    cvector_free(start_to_point);
+    cvector_free(end_to_point);
+    PROGRAM_FREE(from_start);
+    PROGRAM_FREE(from_end);
+    PROGRAM_FREE(marks);
+    PROGRAM_FREE(seen);
+    PROGRAM_FREE(queue);
+    PROGRAM_FREE(empty);
+    return size;
+}
 
-            if (!core_is_in_bounds(maze, neighbor))
-                continue;
+static bool calculate_move(maze_t maze, location_t current, location_t *neighbor) {
+    // Applies the block entered by the move, false when it can't be entered.
+    neighbor->drills = current.drills;
+    neighbor->accumulation_cost = current.accumulation_cost + 2;
 
-            path_t flag = NULL;
-            cvector_for_each_in(flag, closed) {
-                if (core_compare_locations(neighbor, *flag))
-                    break;
-            }
+    switch (*core_get_block_location(maze, *neighbor)) {
+        case SNAKE_DANGER_CHAR:
+            neighbor->coins /= 2;
+            neighbor->dangers++;
+            break;
+        case SNAKE_COIN_CHAR:
+            neighbor->accumulation_cost -= 1;
+            neighbor->coins += 1;
+            break;
+        case SNAKE_DRILL_CHAR:
+            neighbor->drills += 3;
+            break;
+        case SNAKE_WALL_CHAR:
+            if (neighbor->drills > 0)
+                neighbor->drills--;
+            else
+                return false;
+            break;
+        default:
+            break;
+    }
 
-            if (detect_overlay) {
-                path_t overlay_flag = NULL;
-                cvector_for_each_in(overlay_flag, overlay) {
-                    if (core_compare_locations(neighbor, *overlay_flag) &&
-                        !core_compare_locations(neighbor, start) && !core_compare_locations(neighbor, end)) {
-                        flag = overlay_flag;
-                        break;
-                    }
-                }
-            }
+    return true;
+}
 
-            if (flag != cvector_end(closed))
-                continue;
+static solver_node_t node_make(solver_nodes_t nodes, location_t l, uint32_t parent, uint64_t hash) {
+    solver_node_t node;
+
+    node.hash = hash;
+    node.parent = parent;
+    node.depth = parent == SOLVER_NO_PARENT ? 1 : nodes[parent].depth + 1;
+    node.accumulation_cost = (uint32_t) l.accumulation_cost;
+    node.drills = (uint16_t) l.drills;
+    node.coins = (uint16_t) l.coins;
+    node.dangers = (uint16_t) l.dangers;
+    node.x = l.x;
+    node.y = l.y;
+    node.comes_from = (uint8_t) l.comes_from;
+
+    return node;
+}
 
-            neighbor.position_cost = calculate_cost(maze, neighbor, end);
-            neighbor.accumulation_cost = current.accumulation_cost + neighbor.position_cost;
-            neighbor.drills = current.drills;
+static uint32_t node_push(solver_nodes_t *nodes, location_t l, uint32_t parent, uint64_t hash) {
+    solver_node_t node = node_make(*nodes, l, parent, hash);
 
-            maze_data_t block = *core_get_block_location(maze, neighbor);
-            switch (block) {
-                case SNAKE_DANGER_CHAR:
-                    neighbor.dangers++;
-                    break;
-                case SNAKE_DRILL_CHAR:
-                    neighbor.drills += 3;
-                    break;
-                case SNAKE_WALL_CHAR:
-                    if (neighbor.drills > 0) {
-                        neighbor.drills--;
-                    } else {
-                        continue;
-                    }
-                    break;
-                default:
-                    break;
-            }
+    cvector_push_back(*nodes, node);
+    return (uint32_t) cvector_size(*nodes) - 1;
+}
 
-            location_t *j;
-            cvector_for_each_in(j, open) {
-                if (core_compare_locations(neighbor, *j))
-                    break;
-            }
+static location_t node_location(const solver_node_t *node) {
+    location_t l = {node->x, node->y};
 
-            if (j != cvector_end(open)) {
-                if (neighbor.accumulation_cost >
-                    j->accumulation_cost)
-                    continue;
-            }
+    l.comes_from = node->comes_from;
+    l.position_cost = 0;
+    l.accumulation_cost = node->accumulation_cost;
+    l.drills = node->drills;
+    l.coins = node->coins;
+    l.dangers = node->dangers;
 
-            cvector_push_back(open, neighbor);
-        }
+    return l;
+}
+
+static bool node_contains(solver_nodes_t nodes, uint32_t index, location_t l) {
+    for (; index != SOLVER_NO_PARENT; index = nodes[index].parent) {
+        if (nodes[index].x == l.x && nodes[index].y == l.y)
+            return true;
     }
 
-    cvector_push_back(path, last_node);
+    return false;
+}
 
-    do {
-        location_t neighbor;
-        for (uint_fast8_t i = 1; i < 5; ++i) {
-            neighbor = core_get_neighbor(last_node, i, 1);
+static void mark_nodes(maze_t maze, bitmap_t mask, solver_nodes_t nodes, uint32_t index, bool value) {
+    for (; index != SOLVER_NO_PARENT; index = nodes[index].parent) {
+        size_t position = (size_t) nodes[index].x + (size_t) nodes[index].y * maze.width;
 
-            if (!core_is_in_bounds(maze, neighbor))
-                continue;
+        if (value)
+            bitmap_set(mask, position);
+        else
+            bitmap_reset(mask, position);
+    }
+}
 
-            path_t found = NULL;
-            cvector_for_each_in(found, closed) {
-                if (core_compare_locations(neighbor, *found)) {
-                    break;
-                }
-            }
+static path_t node_path(solver_nodes_t nodes, uint32_t index) {
+    // Only the path of the chosen node is materialized, walking back its parents.
+    path_t path = NULL;
+    size_t length = nodes[index].depth;
 
-            if (detect_overlay) {
-                path_t iterator = NULL;
-                cvector_reverse_for_each_in(iterator, overlay) {
-                        if (core_compare_locations(neighbor, *iterator) &&
-                            !core_compare_locations(neighbor, start) && !core_compare_locations(neighbor, end)) {
-                            found = cvector_end(closed);
-                            break;
-                        }
-                    }
-            }
+    cvector_reserve(path, length);
+    cvector_set_size(path, length);
+    for (; index != SOLVER_NO_PARENT; index = nodes[index].parent)
+        path[--length] = node_location(&nodes[index]);
 
-            if (found != cvector_end(closed)) {
-                if (found->accumulation_cost == last_node.accumulation_cost - last_node.position_cost) {
-                    cvector_push_back(path, last_node = *found);
-                }
+    return path;
+}
+
+static uint32_t frontier_key(solver_frontier_key_t key, const solver_node_t *node, location_t end) {
+    switch (key) {
+        case SOLVER_FRONTIER_SCORE: {
+            // Lower keys are better, the coins are counted down from the most a node can hold.
+            uint32_t distance = calculate_distance(node_location(node), end);
+            return node->depth + distance + 10 * (uint32_t) (UINT16_MAX - node->coins);
+        }
+        case SOLVER_FRONTIER_DEPTH:
+            return UINT32_MAX - node->depth;
+        default:
+            return node->accumulation_cost;
+    }
+}
+
+static queue_priority_t frontier_priority(solver_frontier_key_t key, solver_nodes_t nodes, uint32_t index,
+                                          location_t end) {
+    return ((queue_priority_t) frontier_key(key, &nodes[index], end) << QUEUE_TIE_BITS) | index;
+}
+
+static void frontier_push(solver_frontier_t *frontier, queue_priority_t priority) {
+    // Nodes are indexed in creation order, on equal keys the oldest one is on top.
+    cvector_push_back(*frontier, priority);
+
+    queue_priority_t *heap = *frontier;
+    size_t position = cvector_size(heap) - 1;
+
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+
+        if (heap[parent] <= priority)
+            break;
+
+        heap[position] = heap[parent];
+        position = parent;
+    }
+
+    heap[position] = priority;
+}
+
+static uint32_t frontier_pop(solver_frontier_t frontier) {
+    queue_priority_t top = frontier[0];
+    size_t size = cvector_size(frontier) - 1;
+    queue_priority_t last = frontier[size];
+    size_t position = 0;
+
+    for (;;) {
+        size_t child = position * 2 + 1;
+
+        if (child >= size)
+            break;
+
+        if (child + 1 < size && frontier[child + 1] < frontier[child])
+            child++;
+
+        if (last <= frontier[child])
+            break;
+
+        frontier[position] = frontier[child];
+        position = child;
+    }
+
+    if (size > 0)
+        frontier[position] = last;
+
+    cvector_set_size(frontier, size);
+    return (uint32_t) top;
+}
+
+static uint_fast8_t calculate_transposition_bits(maze_t maze) {
+    // Small mazes don't need the whole table.
+    size_t cells = (size_t) maze.width * maze.height;
+    uint_fast8_t bits = 10;
+
+    while (bits < PROGRAM_SOLVER_TRANSPOSITION_BITS && ((size_t) 1 << bits) < cells * 256)
+        bits++;
+
+    return bits;
+}
+
+static uint64_t node_hash(const zobrist_t *keys, maze_t maze, const solver_node_t *from, location_t to) {
+    // The position moves, the counters that changed are swapped.
+    uint64_t hash = from->hash;
+    uint32_t position = calculate_index(maze, to);
+
+    hash ^= keys->positions[(uint32_t) from->x + (uint32_t) from->y * maze.width] ^ keys->positions[position];
+
+    if (to.drills != from->drills)
+        hash ^= zobrist_counter(ZOBRIST_DRILLS, from->drills) ^ zobrist_counter(ZOBRIST_DRILLS, to.drills);
+
+    if (to.dangers != from->dangers)
+        hash ^= zobrist_counter(ZOBRIST_DANGERS, from->dangers) ^ zobrist_counter(ZOBRIST_DANGERS, to.dangers);
+
+    return hash;
+}
+
+static size_t labels_collectables(maze_t maze) {
+    size_t collectables = 0;
+
+    for (size_t i = 0; i < (size_t) maze.width * maze.height; ++i)
+        collectables += maze.blocks[i] == SNAKE_COIN_CHAR || maze.blocks[i] == SNAKE_DRILL_CHAR;
+
+    return collectables;
+}
+
+static void labels_init(solver_labels_t *labels, maze_t maze) {
+    size_t cells = (size_t) maze.width * maze.height;
+    uint32_t collectables = 0;
+
+    labels->heads = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    labels->bits = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    labels->next = NULL;
+    labels->sets = NULL;
+    memset(labels->heads, 0xFF, cells * sizeof(uint32_t));
+
+    for (size_t i = 0; i < cells; ++i) {
+        maze_data_t block = maze.blocks[i];
+        labels->bits[i] = block == SNAKE_COIN_CHAR || block == SNAKE_DRILL_CHAR ? collectables++ : SOLVER_NO_PARENT;
+    }
+
+    labels->words = collectables / 64 + 1;
+}
+
+static void labels_free(solver_labels_t labels) {
+    PROGRAM_FREE(labels.heads);
+    PROGRAM_FREE(labels.bits);
+    cvector_free(labels.next);
+    cvector_free(labels.sets);
+}
+
+static void labels_track(solver_labels_t *labels, uint32_t node, uint32_t parent, uint32_t collected) {
+    // The set of a node is the one of its parent plus the block it collected.
+    size_t words = labels->words;
+
+    cvector_push_back(labels->next, SOLVER_NO_PARENT);
+    for (size_t i = 0; i < words; ++i)
+        cvector_push_back(labels->sets, parent == SOLVER_NO_PARENT ? 0 : labels->sets[parent * words + i]);
+
+    if (collected != SOLVER_NO_PARENT)
+        labels->sets[node * words + collected / 64] |= (uint64_t) 1 << (collected % 64);
+}
+
+static void labels_untrack(solver_labels_t *labels) {
+    cvector_set_size(labels->next, cvector_size(labels->next) - 1);
+    cvector_set_size(labels->sets, cvector_size(labels->sets) - labels->words);
+}
+
+static int labels_compare(const solver_labels_t *labels, solver_nodes_t nodes, uint32_t a, uint32_t b) {
+    // Returns 1 when a dominates b, 0 when they are equal and -1 otherwise.
+    if (nodes[a].depth > nodes[b].depth || nodes[a].coins < nodes[b].coins || nodes[a].drills < nodes[b].drills)
+        return -1;
+
+    bool strict = nodes[a].depth < nodes[b].depth || nodes[a].coins > nodes[b].coins ||
+                  nodes[a].drills > nodes[b].drills;
+
+    // Every block collected by a must be collected by b too, or b could still reach something that a took.
+    const uint64_t *set_a = &labels->sets[a * labels->words], *set_b = &labels->sets[b * labels->words];
+    for (size_t i = 0; i < labels->words; ++i) {
+        if (set_a[i] & ~set_b[i])
+            return -1;
+
+        strict |= set_a[i] != set_b[i];
+    }
+
+    return strict ? 1 : 0;
+}
+
+static bool labels_insert(solver_labels_t *labels, solver_statistics_t *counters, solver_nodes_t nodes,
+                          uint32_t position, uint32_t node) {
+    /*
+     * The new label is discarded when a label of the block dominates it,
+     * otherwise it removes the labels that it dominates.
+     *
+     * Equal labels are both kept, a path can't revisit its blocks so
+     * they aren't interchangeable, but only the first one is linked:
+     * it prunes the same labels that the new one would prune.
+     */
+    uint32_t *link = &labels->heads[position];
+
+    while (*link != SOLVER_NO_PARENT) {
+        uint32_t other = *link;
+        int compared = labels_compare(labels, nodes, other, node);
+
+        if (compared > 0) {
+            counters->labels_dominated++;
+            return false;
+        }
+
+        if (compared == 0)
+            return true;
+
+        if (labels_compare(labels, nodes, node, other) > 0) {
+            *link = labels->next[other];
+            labels->next[other] = SOLVER_LABEL_DEAD;
+            counters->labels_removed++;
+        } else {
+            link = &labels->next[other];
+        }
+    }
+
+    labels->next[node] = labels->heads[position];
+    labels->heads[position] = node;
+    return true;
+}
+
+static bool labels_alive(solver_labels_t labels, uint32_t node) {
+    return labels.next[node] != SOLVER_LABEL_DEAD;
+}
+
+/*
+ * The steps of a search shared by solver_search and parallel_work.
+ * The lock guards the nodes and the frontier from the thieves,
+ * it's NULL when the search runs on a single thread, as are the
+ * keys and the table without transposition and the labels when
+ * they are not kept.
+ */
+
+static bool search_complete(const solver_control_t *control, location_t current, uint_fast16_t total_coins) {
+    // The estimated coins have been collected, only a precise search keeps going.
+    return current.coins >= total_coins && !control->precise;
+}
+
+static uint32_t search_tail(maze_t maze, solver_workspace_t *w, solver_nodes_t *nodes, uint32_t node_current,
+                            path_t *shortest, const zobrist_t *keys, solver_labels_t *labels, pthread_mutex_t *lock) {
+    location_t current = node_location(&(*nodes)[node_current]);
+
+    mark_nodes(maze, w->overlay, *nodes, node_current, true);
+    solver_execute_astar_into(w, maze, current, maze.end, &w->overlay, false, shortest);
+    mark_nodes(maze, w->overlay, *nodes, node_current, false);
+
+    if (lock)
+        pthread_mutex_lock(lock);
+
+    for (size_t i = 0; i < cvector_size(*shortest); ++i) {
+        location_t l = (*shortest)[i];
+
+        // The last location keeps what has been collected by the path.
+        if (i + 1 == cvector_size(*shortest)) {
+            l.coins = current.coins;
+            l.drills = current.drills;
+            l.dangers = current.dangers;
+        }
+
+        uint64_t hash = keys ? node_hash(keys, maze, &(*nodes)[node_current], l) : 0;
+        uint32_t node_tail = node_push(nodes, l, node_current, hash);
+
+        // The blocks of the tail are not counted, the set doesn't change.
+        if (labels)
+            labels_track(labels, node_tail, node_current, SOLVER_NO_PARENT);
+
+        node_current = node_tail;
+    }
+
+    if (lock)
+        pthread_mutex_unlock(lock);
+
+    return node_current;
+}
+
+static void search_expand(maze_t maze, solver_frontier_key_t key, solver_nodes_t *nodes, solver_frontier_t *open,
+                          uint32_t node_current, const zobrist_t *keys, transposition_t *table,
+                          solver_labels_t *labels, solver_statistics_t *counters, pthread_mutex_t *lock) {
+    location_t current = node_location(&(*nodes)[node_current]);
+
+    if (lock)
+        pthread_mutex_lock(lock);
+
+    for (uint_fast8_t i = 1; i < 5; ++i) {
+        // Never go back in best_path
+        if (current.comes_from == i)
+            continue;
+
+        location_t neighbor = core_get_neighbor(current, i, 1);
+
+        if (!core_is_in_bounds(maze, neighbor) || node_contains(*nodes, node_current, neighbor))
+            continue;
+
+        maze_data_t block = *core_get_block_location(maze, neighbor);
+        if (!calculate_move(maze, current, &neighbor))
+            continue;
+
+        uint64_t hash = 0;
+        if (keys) {
+            hash = node_hash(keys, maze, &(*nodes)[node_current], neighbor);
+
+            if (block == SNAKE_COIN_CHAR || block == SNAKE_DRILL_CHAR || block == SNAKE_WALL_CHAR)
+                hash ^= keys->collected[calculate_index(maze, neighbor)];
+
+            if (transposition_dominated(table, hash, (uint32_t) neighbor.accumulation_cost,
+                                        (uint16_t) neighbor.coins))
+                continue;
+        }
+
+        uint32_t node_neighbor = node_push(nodes, neighbor, node_current, hash);
+        if (labels) {
+            uint32_t position = calculate_index(maze, neighbor);
+            labels_track(labels, node_neighbor, node_current, labels->bits[position]);
+
+            if (!labels_insert(labels, counters, *nodes, position, node_neighbor)) {
+                cvector_pop_back(*nodes);
+                labels_untrack(labels);
+                continue;
+            }
+        }
+
+        frontier_push(open, frontier_priority(key, *nodes, node_neighbor, maze.end));
+        counters->generated++;
+    }
+
+    if (lock)
+        pthread_mutex_unlock(lock);
+}
+
+static path_t solver_search(maze_t maze, solver_frontier_key_t key, solver_control_t *control,
+                            solver_statistics_t *statistics) {
+    location_t start = maze.start;
+    solver_nodes_t nodes = NULL;
+    solver_frontier_t open = NULL;
+    cvector_vector_type(uint32_t) ended = NULL;
+    solver_statistics_t counters = {0};
+    double started = solver_now();
+
+    /*
+     * A state is the block reached, the blocks collected on the way
+     * (coins, drills and drilled walls), the drills left and the dangers
+     * took. Paths that reach a state already reached with no more cost
+     * and no fewer coins are dropped before entering the frontier.
+     */
+    bool transposing = PROGRAM_SOLVER_TRANSPOSITION_BITS > 0;
+    transposition_t table = {NULL};
+    zobrist_t keys = {NULL};
+
+    bool labeling = PROGRAM_SOLVER_PARETO && labels_collectables(maze) <= PROGRAM_SOLVER_PARETO_COLLECTABLES;
+    solver_labels_t labels = {NULL};
+
+    if (labeling)
+        labels_init(&labels, maze);
+
+    if (transposing) {
+        transposition_init(&table, calculate_transposition_bits(maze));
+        zobrist_init(&keys, (size_t) maze.width * maze.height);
+    }
+
+    path_t shortest = NULL;
+    solver_workspace_t w;
+    solver_init_workspace(&w, maze);
+
+    /*
+     * The shortest path is the first answer, returned when
+     * the deadline comes before any path has been completed.
+     */
+    path_t fallback = NULL;
+    int_fast32_t best_score = INT_FAST32_MIN;
+
+    if (solver_execute_astar_into(&w, maze, start, maze.end, NULL, false, &fallback)) {
+        solver_collect_with(&w, maze, fallback);
+        best_score = solver_score(fallback);
+
+        if (control->improved)
+            control->improved(fallback, best_score, control->context);
+    }
+
+    int_fast16_t path_score = INT16_MIN;
+    uint_fast16_t total_coins = estimate_coins(&w, maze, control->deadline);
+    double searching = solver_now();
+    counters.estimation = searching - started;
+
+    start.accumulation_cost = 2;
+    start.drills = 0;
+    start.coins = 0;
+    start.dangers = 0;
+
+    /*
+     * Every expanded path is a node of a search tree stored in
+     * an arena, a node keeps only its last location and the
+     * index of its parent, so expanding a path doesn't copy it.
+     */
+    uint64_t hash_start = 0;
+    if (transposing) {
+        hash_start = keys.positions[calculate_index(maze, start)] ^ zobrist_counter(ZOBRIST_DRILLS, 0) ^
+                     zobrist_counter(ZOBRIST_DANGERS, 0);
+        transposition_dominated(&table, hash_start, (uint32_t) start.accumulation_cost, 0);
+    }
+
+    uint32_t node_start = node_push(&nodes, start, SOLVER_NO_PARENT, hash_start);
+    if (labeling) {
+        labels_track(&labels, node_start, SOLVER_NO_PARENT, SOLVER_NO_PARENT);
+        labels_insert(&labels, &counters, nodes, calculate_index(maze, start), node_start);
+    }
+
+    frontier_push(&open, frontier_priority(key, nodes, node_start, maze.end));
+    counters.generated++;
+
+    const zobrist_t *hashing = transposing ? &keys : NULL;
+    solver_labels_t *tracking = labeling ? &labels : NULL;
+
+    // Every path has been expanded or dropped as dominated, unless the loop breaks.
+    counters.completed = true;
+
+    while (cvector_size(open) > 0) {
+        if (solver_expired(control)) {
+            counters.completed = false;
+            break;
+        }
+
+        uint32_t node_current = frontier_pop(open);
+
+        // The label of the path has been dominated while it was waiting.
+        if (labeling && !labels_alive(labels, node_current))
+            continue;
+
+        counters.expanded++;
+
+        location_t current = node_location(&nodes[node_current]);
+        uint32_t node_popped = node_current;
+
+        if (current.coins >= total_coins) {
+            node_current = search_tail(maze, &w, &nodes, node_current, &shortest, hashing, tracking, NULL);
+            current = node_location(&nodes[node_current]);
+        }
+
+        if (core_compare_locations(current, maze.end)) {
+            int_fast16_t current_score = calculate_score(current.coins, nodes[node_current].depth);
+
+            if (current_score >= path_score) {
+                cvector_push_back(ended, node_current);
+                path_score = current_score;
+
+                if (control->improved) {
+                    path_t path = node_path(nodes, node_current);
+                    solver_collect_with(&w, maze, path);
+                    int_fast32_t score = solver_score(path);
+
+                    if (score > best_score) {
+                        best_score = score;
+                        control->improved(path, score, control->context);
+                    }
+
+                    cvector_free(path);
+                }
+
+                // Timeout is set to 30 seconds.
+                // If we reach that timeout it means that the estimation was wrong,
+                // and we could not reach that amount of collected coins.
+                if (search_complete(control, current, total_coins)) {
+                    // we found the best_path that reached our
+                    // estimation
+                    counters.completed = false;
+                    break;
+                }
+            }
+
+            /*
+             * The game ends on the end. A precise search still expands the
+             * path completed by the tail, the estimation can be wrong and
+             * collecting more coins before the end can score more.
+             */
+            if (!control->precise || node_popped == node_current)
+                continue;
+        }
+
+        search_expand(maze, key, &nodes, &open, node_popped, hashing, &table, tracking, &counters, NULL);
+    }
+
+    counters.seconds = solver_now() - searching;
+    if (transposing) {
+        counters.transposition_hits = table.hits;
+        counters.transposition_misses = table.misses;
+        counters.transposition_overwrites = table.overwrites;
+
+        transposition_free(table);
+        zobrist_free(keys);
+    }
+
+    if (labeling)
+        labels_free(labels);
+
+    if (statistics)
+        *statistics = counters;
+
+    int_fast16_t max_score = INT16_MIN;
+    uint32_t *iterator, best_node = SOLVER_NO_PARENT;
+    cvector_reverse_for_each_in(iterator, ended) {
+            int_fast16_t score = calculate_score(nodes[*iterator].coins, nodes[*iterator].depth);
+            if (score >= max_score) {
+                max_score = score;
+                best_node = *iterator;
             }
         }
-    } while (!core_compare_locations(last_node, start));
 
-    cvector_free(closed);
+    path_t best_path = best_node != SOLVER_NO_PARENT ? node_path(nodes, best_node) : NULL;
+
+    // The tail of a* can walk on blocks already collected, they are counted again on the whole path.
+    if (best_path)
+        solver_collect_with(&w, maze, best_path);
+
+    if (solver_score(fallback) > solver_score(best_path)) {
+        cvector_free(best_path);
+        best_path = fallback;
+        fallback = NULL;
+    }
+
+    cvector_free(fallback);
+    cvector_free(nodes);
     cvector_free(open);
+    cvector_free(ended);
+    cvector_free(shortest);
+    solver_free_workspace(w);
+
+    return best_path;
+}
+
+static int beam_compare(const void *a, const void *b) {
+    uint64_t first = *(const uint64_t *) a, second = *(const uint64_t *) b;
+    return (first > second) - (first < second);
+}
+
+static uint32_t *beam_bonus(maze_t maze) {
+    // Every block sums what the coins around it are worth, coins are rare so they spread their value.
+    uint32_t *bonus = (uint32_t *) PROGRAM_CALLOC((size_t) maze.width * maze.height, sizeof(uint32_t));
+
+    for (int y = 0; y < maze.height; ++y) {
+        for (int x = 0; x < maze.width; ++x) {
+            if (maze.blocks[x + y * maze.width] != SNAKE_COIN_CHAR)
+                continue;
+
+            for (int dy = -SOLVER_BEAM_RADIUS; dy <= SOLVER_BEAM_RADIUS; ++dy) {
+                int reach = SOLVER_BEAM_RADIUS - abs(dy);
+
+                for (int dx = -reach; dx <= reach; ++dx) {
+                    if (x + dx < 0 || y + dy < 0 || x + dx >= maze.width || y + dy >= maze.height)
+                        continue;
+
+                    bonus[(x + dx) + (y + dy) * maze.width] += 10 - 2 * (abs(dx) + abs(dy));
+                }
+            }
+        }
+    }
+
+    return bonus;
+}
+
+path_t solver_execute_beam(maze_t maze, size_t width, solver_beam_rank_t rank, const solver_control_t *control,
+                           solver_statistics_t *statistics) {
+    size_t cells = (size_t) maze.width * maze.height;
+    location_t start = maze.start;
+    solver_nodes_t nodes = NULL, candidates = NULL;
+    cvector_vector_type(uint32_t) beam = NULL;
+    cvector_vector_type(uint32_t) next = NULL;
+    cvector_vector_type(uint64_t) ranked = NULL;
+    solver_statistics_t counters = {0};
+    double started = solver_now();
+
+    if (width == 0)
+        width = 1;
+
+    uint32_t *bonus = rank == SOLVER_BEAM_OPTIMISTIC ? beam_bonus(maze) : NULL;
+    uint32_t *stamps = (uint32_t *) PROGRAM_CALLOC(cells, sizeof(uint32_t));
+    uint32_t *kept = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *walked = (uint32_t *) PROGRAM_CALLOC(cells, sizeof(uint32_t)), token = 0;
+
+    uint_fast32_t total_coins = 0;
+    for (size_t i = 0; i < cells; ++i)
+        total_coins += maze.blocks[i] == SNAKE_COIN_CHAR;
+
+    double searching = solver_now();
+    counters.estimation = searching - started;
+
+    start.accumulation_cost = 2;
+    start.drills = 0;
+    start.coins = 0;
+    start.dangers = 0;
+
+    cvector_push_back(beam, node_push(&nodes, start, SOLVER_NO_PARENT, 0));
+
+    /*
+     * Every step grows all the kept paths by one block, so the candidates
+     * have the same depth. Only the best width of them are stored in the
+     * arena, the others are dropped without leaving nodes behind.
+     */
+    int_fast32_t best_score = INT_FAST32_MIN;
+    uint32_t best_node = SOLVER_NO_PARENT;
+
+    for (uint32_t step = 1; cvector_size(beam) > 0 && !solver_expired(control); ++step) {
+        // No path can beat the best one, even collecting every coin of the maze.
+        if (best_node != SOLVER_NO_PARENT && 1000 + 10 * (int_fast32_t) total_coins - (int_fast32_t) step <= best_score)
+            break;
+
+        cvector_set_size(candidates, 0);
+        cvector_set_size(ranked, 0);
+
+        for (size_t k = 0; k < cvector_size(beam); ++k) {
+            uint32_t node_current = beam[k];
+            location_t current = node_location(&nodes[node_current]);
+            counters.expanded++;
+
+            // The path is marked once, instead of being walked back for every neighbor.
+            token++;
+            for (uint32_t index = node_current; index != SOLVER_NO_PARENT; index = nodes[index].parent)
+                walked[(uint32_t) nodes[index].x + (uint32_t) nodes[index].y * maze.width] = token;
+
+            for (uint_fast8_t i = 1; i < 5; ++i) {
+                if (current.comes_from == i)
+                    continue;
+
+                location_t neighbor = core_get_neighbor(current, i, 1);
+
+                if (!core_is_in_bounds(maze, neighbor) || walked[calculate_index(maze, neighbor)] == token)
+                    continue;
+
+                if (!calculate_move(maze, current, &neighbor))
+                    continue;
+
+                counters.generated++;
+                solver_node_t candidate = node_make(nodes, neighbor, node_current, 0);
+
+                // The game ends on the end, the path can only be compared with the best one.
+                if (core_compare_locations(neighbor, maze.end)) {
+                    int_fast32_t score = calculate_score(candidate.coins, candidate.depth - 1);
+
+                    if (score > best_score) {
+                        best_score = score;
+                        best_node = node_push(&nodes, neighbor, node_current, 0);
+                    }
+
+                    continue;
+                }
+
+                int_fast64_t value = 10 * (int_fast64_t) candidate.coins - candidate.depth;
+                if (bonus)
+                    value += bonus[calculate_index(maze, neighbor)];
+
+                // Lower keys are better, on equal values the candidate generated first wins.
+                uint64_t key = (uint64_t) ((int_fast64_t) INT32_MAX - value) << 32 | cvector_size(candidates);
+                cvector_push_back(candidates, candidate);
+                cvector_push_back(ranked, key);
+            }
+        }
+
+        if (ranked)
+            qsort(ranked, cvector_size(ranked), sizeof(uint64_t), beam_compare);
+
+        cvector_set_size(next, 0);
+        for (size_t k = 0; k < cvector_size(ranked) && cvector_size(next) < width; ++k) {
+            const solver_node_t *candidate = &candidates[(uint32_t) ranked[k]];
+            uint32_t position = (uint32_t) candidate->x + (uint32_t) candidate->y * maze.width;
+
+            // A better ranked path on the same block with no fewer coins and drills makes this one useless.
+            if (stamps[position] == step) {
+                const solver_node_t *other = &nodes[kept[position]];
+
+                if (other->coins >= candidate->coins && other->drills >= candidate->drills)
+                    continue;
+            }
+
+            cvector_push_back(nodes, *candidate);
+            stamps[position] = step;
+            kept[position] = (uint32_t) cvector_size(nodes) - 1;
+            cvector_push_back(next, kept[position]);
+        }
+
+        cvector_vector_type(uint32_t) swap = beam;
+        beam = next;
+        next = swap;
+    }
+
+    counters.seconds = solver_now() - searching;
+    if (statistics)
+        *statistics = counters;
+
+    path_t best_path = best_node != SOLVER_NO_PARENT ? node_path(nodes, best_node) : NULL;
+
+    if (bonus)
+        PROGRAM_FREE(bonus);
+
+    PROGRAM_FREE(stamps);
+    PROGRAM_FREE(kept);
+    PROGRAM_FREE(walked);
+    cvector_free(nodes);
+    cvector_free(candidates);
+    cvector_free(beam);
+    cvector_free(next);
+    cvector_free(ranked);
+
+    return best_path;
+}
+
+path_t solver_execute_full(maze_t maze) {
+    return solver_execute_full_with(maze, PROGRAM_SOLVER_FRONTIER, NULL);
+}
+
+path_t solver_execute_full_with(maze_t maze, solver_frontier_key_t key, solver_statistics_t *statistics) {
+    solver_control_t control = {solver_now() + PROGRAM_SOLVER_TIMEOUT, PROGRAM_SOLVER_FULL_PRECISION};
+    return solver_search(maze, key, &control, statistics);
+}
+
+path_t solver_execute_anytime(maze_t maze, double deadline, solver_improved_t improved, void *context,
+                              solver_statistics_t *statistics) {
+    solver_control_t control = {deadline, PROGRAM_SOLVER_FULL_PRECISION, NULL, improved, context};
+    return solver_search(maze, PROGRAM_SOLVER_FRONTIER, &control, statistics);
+}
+
+path_t solver_execute_controlled(maze_t maze, solver_control_t *control, solver_statistics_t *statistics) {
+    return solver_search(maze, PROGRAM_SOLVER_FRONTIER, control, statistics);
+}
+
+static int_fast32_t parallel_bound(const solver_parallel_t *shared, const solver_node_t *node) {
+    // Every coin of the maze collected and a straight walk to the end.
+    uint_fast32_t distance = calculate_distance(node_location(node), shared->maze.end);
+    return 1000 - (int_fast32_t) (node->depth + distance) + 10 * (int_fast32_t) shared->coin_blocks;
+}
+
+static void parallel_improve(solver_parallel_t *shared, int_fast32_t score) {
+    int_fast32_t incumbent = __atomic_load_n(&shared->incumbent, __ATOMIC_RELAXED);
+
+    while (score > incumbent &&
+           !__atomic_compare_exchange_n(&shared->incumbent, &incumbent, score, true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED));
+}
+
+static bool parallel_steal(solver_worker_t *thief) {
+    solver_parallel_t *shared = thief->shared;
+    solver_nodes_t chain = NULL;
+
+    for (size_t k = 1; k < shared->threads && chain == NULL; ++k) {
+        solver_worker_t *victim = &shared->workers[(thief->id + k) % shared->threads];
+
+        // A busy victim is skipped, the thief doesn't wait.
+        if (pthread_mutex_trylock(&victim->lock) != 0)
+            continue;
+
+        if (cvector_size(victim->open) > 0) {
+            uint32_t stolen = frontier_pop(victim->open);
+
+            // The thief has work before the victim loses it, so active never drops to 0 with paths left.
+            __atomic_add_fetch(&shared->active, 1, __ATOMIC_SEQ_CST);
+
+            size_t depth = victim->nodes[stolen].depth;
+            cvector_reserve(chain, depth);
+            cvector_set_size(chain, depth);
+            for (uint32_t index = stolen; index != SOLVER_NO_PARENT; index = victim->nodes[index].parent)
+                chain[--depth] = victim->nodes[index];
+        }
+
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    if (chain == NULL)
+        return false;
+
+    // The path is copied from the root, the parents point inside the arena of the thief.
+    pthread_mutex_lock(&thief->lock);
+
+    uint32_t parent = SOLVER_NO_PARENT;
+    for (size_t i = 0; i < cvector_size(chain); ++i) {
+        chain[i].parent = parent;
+        cvector_push_back(thief->nodes, chain[i]);
+        parent = (uint32_t) cvector_size(thief->nodes) - 1;
+    }
+
+    frontier_push(&thief->open, frontier_priority(shared->key, thief->nodes, parent, shared->maze.end));
+    pthread_mutex_unlock(&thief->lock);
+
+    thief->counters.steals++;
+    cvector_free(chain);
+    return true;
+}
+
+static bool parallel_expired(solver_parallel_t *shared) {
+    if (__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE))
+        return true;
+
+    if (solver_expired(shared->control)) {
+        __atomic_store_n(&shared->stop, true, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    return false;
+}
+
+static void *parallel_work(void *argument) {
+    solver_worker_t *worker = (solver_worker_t *) argument;
+    solver_parallel_t *shared = worker->shared;
+    maze_t maze = shared->maze;
+
+#if defined(PROGRAM_RP_ALLOCATOR) && PROGRAM_RP_ALLOCATOR == true
+    rpmalloc_thread_initialize();
+#endif
+
+    // Only the first worker starts with a path, the others start stealing.
+    bool active = worker->id == 0;
+
+    while (!parallel_expired(shared)) {
+        pthread_mutex_lock(&worker->lock);
+        bool empty = cvector_size(worker->open) == 0;
+        uint32_t node_current = empty ? SOLVER_NO_PARENT : frontier_pop(worker->open);
+        pthread_mutex_unlock(&worker->lock);
+
+        if (empty) {
+            if (active) {
+                __atomic_sub_fetch(&shared->active, 1, __ATOMIC_SEQ_CST);
+                active = false;
+            }
+
+            if (parallel_steal(worker)) {
+                active = true;
+                continue;
+            }
+
+            // Every worker is idle, there's nothing left to expand.
+            if (__atomic_load_n(&shared->active, __ATOMIC_SEQ_CST) == 0) {
+                __atomic_store_n(&shared->completed, true, __ATOMIC_RELEASE);
+                __atomic_store_n(&shared->stop, true, __ATOMIC_RELEASE);
+            }
+
+            sched_yield();
+            continue;
+        }
+
+        if (parallel_bound(shared, &worker->nodes[node_current]) < __atomic_load_n(&shared->incumbent, __ATOMIC_RELAXED))
+            continue;
+
+        worker->counters.expanded++;
+        location_t current = node_location(&worker->nodes[node_current]);
+        const zobrist_t *hashing = PROGRAM_SOLVER_TRANSPOSITION_BITS > 0 ? &shared->keys : NULL;
+        uint32_t node_popped = node_current;
+
+        if (current.coins >= shared->total_coins) {
+            node_current = search_tail(maze, &worker->w, &worker->nodes, node_current, &worker->shortest, hashing,
+                                       NULL, &worker->lock);
+            current = node_location(&worker->nodes[node_current]);
+        }
+
+        // The game ends on the end, the path is not expanded further.
+        if (core_compare_locations(current, maze.end)) {
+            int_fast32_t score = calculate_score(current.coins, worker->nodes[node_current].depth);
+
+            if (score > worker->best_score) {
+                worker->best_score = score;
+                worker->best_node = node_current;
+                parallel_improve(shared, score);
+            }
+
+            if (search_complete(shared->control, current, shared->total_coins))
+                __atomic_store_n(&shared->stop, true, __ATOMIC_RELEASE);
+
+            // As in solver_search a precise search still expands the path completed by the tail.
+            if (!shared->control->precise || node_popped == node_current)
+                continue;
+        }
+
+        search_expand(maze, shared->key, &worker->nodes, &worker->open, node_popped, hashing, &worker->table, NULL,
+                      &worker->counters, &worker->lock);
+    }
+
+#if defined(PROGRAM_RP_ALLOCATOR) && PROGRAM_RP_ALLOCATOR == true
+    rpmalloc_thread_finalize(1);
+#endif
+
+    return NULL;
+}
+
+path_t solver_execute_parallel(maze_t maze, size_t threads, solver_control_t *control,
+                               solver_statistics_t *statistics) {
+    size_t cells = (size_t) maze.width * maze.height;
+    location_t start = maze.start;
+    solver_parallel_t shared;
+    solver_statistics_t counters = {0};
+    double started = solver_now();
+
+    threads = threads < 1 ? 1 : threads > SOLVER_MAX_THREADS ? SOLVER_MAX_THREADS : threads;
+
+    shared.maze = maze;
+    shared.key = PROGRAM_SOLVER_FRONTIER;
+    shared.control = control;
+    shared.threads = threads;
+    shared.incumbent = INT_FAST32_MIN;
+    shared.active = 1;
+    shared.stop = false;
+    shared.completed = false;
+    shared.coin_blocks = 0;
+
+    for (size_t i = 0; i < cells; ++i)
+        shared.coin_blocks += maze.blocks[i] == SNAKE_COIN_CHAR;
+
+    solver_workspace_t w;
+    solver_init_workspace(&w, maze);
+
+    // As in solver_execute_anytime the shortest path is the answer when no path is completed.
+    path_t fallback = NULL;
+    if (solver_execute_astar_into(&w, maze, start, maze.end, NULL, false, &fallback))
+        solver_collect_with(&w, maze, fallback);
+
+    shared.total_coins = estimate_coins(&w, maze, control->deadline);
+    solver_free_workspace(w);
+
+    double searching = solver_now();
+    counters.estimation = searching - started;
+
+    if (PROGRAM_SOLVER_TRANSPOSITION_BITS > 0)
+        zobrist_init(&shared.keys, cells);
+
+    shared.workers = (solver_worker_t *) PROGRAM_CALLOC(threads, sizeof(solver_worker_t));
+    for (size_t i = 0; i < threads; ++i) {
+        solver_worker_t *worker = &shared.workers[i];
+
+        pthread_mutex_init(&worker->lock, NULL);
+        worker->shared = &shared;
+        worker->id = i;
+        worker->best_node = SOLVER_NO_PARENT;
+        worker->best_score = INT_FAST32_MIN;
+        solver_init_workspace(&worker->w, maze);
+
+        if (PROGRAM_SOLVER_TRANSPOSITION_BITS > 0)
+            transposition_init(&worker->table, calculate_transposition_bits(maze));
+    }
+
+    start.accumulation_cost = 2;
+    start.drills = 0;
+    start.coins = 0;
+    start.dangers = 0;
+
+    // The first worker starts from the root, the others steal from it.
+    uint64_t hash_start = 0;
+    if (PROGRAM_SOLVER_TRANSPOSITION_BITS > 0) {
+        hash_start = shared.keys.positions[calculate_index(maze, start)] ^ zobrist_counter(ZOBRIST_DRILLS, 0) ^
+                     zobrist_counter(ZOBRIST_DANGERS, 0);
+        transposition_dominated(&shared.workers[0].table, hash_start, (uint32_t) start.accumulation_cost, 0);
+    }
+
+    uint32_t node_start = node_push(&shared.workers[0].nodes, start, SOLVER_NO_PARENT, hash_start);
+    frontier_push(&shared.workers[0].open,
+                  frontier_priority(shared.key, shared.workers[0].nodes, node_start, maze.end));
+
+    // Only the workers whose thread started are joined, with none the first one runs here.
+    size_t started_threads = 0;
+    for (size_t i = 0; i < threads; ++i) {
+        shared.workers[i].started = pthread_create(&shared.workers[i].thread, NULL, parallel_work,
+                                                   &shared.workers[i]) == 0;
+        started_threads += shared.workers[i].started;
+    }
+
+    if (started_threads == 0)
+        parallel_work(&shared.workers[0]);
+
+    path_t best_path = fallback;
+    for (size_t i = 0; i < threads; ++i) {
+        solver_worker_t *worker = &shared.workers[i];
+
+        if (worker->started)
+            pthread_join(worker->thread, NULL);
+
+        counters.expanded += worker->counters.expanded;
+        counters.generated += worker->counters.generated;
+        counters.steals += worker->counters.steals;
+        counters.transposition_hits += worker->table.hits;
+        counters.transposition_misses += worker->table.misses;
+        counters.transposition_overwrites += worker->table.overwrites;
+
+        if (worker->best_node != SOLVER_NO_PARENT) {
+            path_t path = node_path(worker->nodes, worker->best_node);
+            solver_collect_with(&worker->w, maze, path);
+
+            if (solver_score(path) > solver_score(best_path)) {
+                cvector_free(best_path);
+                best_path = path;
+            } else {
+                cvector_free(path);
+            }
+        }
+    }
+
+    counters.seconds = solver_now() - searching;
+    counters.completed = shared.completed;
+    if (statistics)
+        *statistics = counters;
+
+    for (size_t i = 0; i < threads; ++i) {
+        solver_worker_t *worker = &shared.workers[i];
+
+        pthread_mutex_destroy(&worker->lock);
+        cvector_free(worker->nodes);
+        cvector_free(worker->open);
+        cvector_free(worker->shortest);
+        solver_free_workspace(worker->w);
+
+        if (PROGRAM_SOLVER_TRANSPOSITION_BITS > 0)
+            transposition_free(worker->table);
+    }
+
+    if (PROGRAM_SOLVER_TRANSPOSITION_BITS > 0)
+        zobrist_free(shared.keys);
+
+    PROGRAM_FREE(shared.workers);
+    return best_path;
+}
+
+void solver_init_workspace(solver_workspace_t *w, maze_t maze) {
+    solver_table_init(&w->table, maze);
+    queue_init(&w->open, w->table.size, PROGRAM_SOLVER_QUEUE);
+    bitmap_init(&w->overlay, (size_t) maze.width * maze.height);
+    w->order = SOLVER_ORDER_ASTAR;
+    w->expanded = 0;
+    w->visits = (solver_visit_t *) PROGRAM_CALLOC((size_t) maze.width * maze.height, sizeof(solver_visit_t));
+    w->replay = 0;
+}
+
+void solver_free_workspace(solver_workspace_t w) {
+    solver_table_free(w.table);
+    queue_free(w.open);
+    bitmap_free(w.overlay);
+    PROGRAM_FREE(w.visits);
+}
+
+void solver_set_workspace_queue(solver_workspace_t *w, queue_kind_t kind) {
+    if (w->open.kind == kind)
+        return;
+
+    size_t capacity = w->open.capacity;
+    queue_free(w->open);
+    queue_init(&w->open, capacity, kind);
+}
+
+path_t solver_execute_astar(maze_t maze, location_t start, location_t end, path_t overlay, bool go_back) {
+    solver_workspace_t w;
+    solver_init_workspace(&w, maze);
+
+    path_t path = NULL;
+    bool detect_overlay = overlay && !cvector_empty(overlay);
+
+    if (detect_overlay)
+        mark_path(maze, w.overlay, overlay, 0, cvector_size(overlay), true);
+
+    solver_execute_astar_into(&w, maze, start, end, detect_overlay ? &w.overlay : NULL, go_back, &path);
+
+    solver_free_workspace(w);
+    return path;
+}
+
+path_t solver_execute_astar_masked(maze_t maze, location_t start, location_t end, const bitmap_t *overlay,
+                                   bool go_back) {
+    solver_workspace_t w;
+    solver_init_workspace(&w, maze);
+
+    path_t path = NULL;
+    solver_execute_astar_into(&w, maze, start, end, overlay, go_back, &path);
+
+    solver_free_workspace(w);
+    return path;
+}
+
+bool solver_execute_astar_into(solver_workspace_t *w, maze_t maze, location_t start, location_t end,
+                               const bitmap_t *overlay, bool go_back, path_t *out) {
+    bool found = false;
+    uint32_t index_start = calculate_index(maze, start), index_end = calculate_index(maze, end);
+    uint32_t state_last, drills_top;
+
+    solver_table_t *table = &w->table;
+    queue_t *open = &w->open;
+
+    /*
+     * The open set is an indexed heap keyed by the state, a block
+     * reached with a certain amount of drills, while the closed set
+     * and the best costs are stored in a table of
+     * maze.width * maze.height * SOLVER_LAYERS records.
+     * Both are owned by the workspace and reused by every search.
+     */
+    queue_clear(open);
+    solver_table_next_generation(table);
+
+    start.position_cost = calculate_position_cost(w->order, maze, start, end);
+    start.accumulation_cost = 0;
+    start.drills = start.drills > SOLVER_MAX_DRILLS ? SOLVER_MAX_DRILLS : start.drills;
+    start.dangers = 0;
+
+    drills_top = (uint32_t) start.drills;
+    state_last = calculate_state(maze, start);
+    solver_table_store(table, maze, start, SOLVER_NO_PARENT);
+    queue_push(open, state_last, calculate_priority(w->order, start, end));
+    while (!queue_empty(open)) {
+        uint32_t state_current = queue_pop(open);
+        location_t current = solver_table_location(w, maze, state_current, start, end);
+
+        if (state_current / SOLVER_LAYERS == index_end) {
+            state_last = state_current;
+            found = true;
+            break;
+        }
+
+        table->cells[state_current].closed = true;
+
+        // A state with more drills could have reached the block after this one has been queued.
+        if (current.drills < drills_top &&
+            solver_table_dominated(table, state_current + 1, (uint32_t) current.accumulation_cost, drills_top))
+            continue;
+
+        w->expanded++;
+        for (uint_fast8_t i = 1; i < 5; ++i) {
+            if (current.comes_from == i && !go_back)
+                continue;
+
+            location_t neighbor = core_get_neighbor(current, i, 1);
+
+            if (!core_is_in_bounds(maze, neighbor))
+                continue;
+
+            uint32_t index = calculate_index(maze, neighbor);
+
+            if (overlay && bitmap_test(*overlay, index) && index != index_start && index != index_end)
+                continue;
+
+            neighbor.position_cost = calculate_position_cost(w->order, maze, neighbor, end);
+            neighbor.accumulation_cost = current.accumulation_cost + neighbor.position_cost;
+
+            maze_data_t block = *core_get_block_location(maze, neighbor);
+            switch (block) {
+                case SNAKE_DANGER_CHAR:
+                    neighbor.dangers++;
+                    break;
+                case SNAKE_DRILL_CHAR:
+                    // The drill block is emptied once collected.
+                    if (!solver_table_visited(table, state_current, index))
+                        neighbor.drills += 3;
+
+                    if (neighbor.drills > SOLVER_MAX_DRILLS)
+                        neighbor.drills = SOLVER_MAX_DRILLS;
+
+                    if (neighbor.drills > drills_top)
+                        drills_top = (uint32_t) neighbor.drills;
+                    break;
+                case SNAKE_WALL_CHAR:
+                    if (neighbor.drills > 0) {
+                        neighbor.drills--;
+                    } else {
+                        continue;
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            uint32_t state = index * SOLVER_LAYERS + (uint32_t) neighbor.drills;
+            solver_cell_t *cell = solver_table_touch(table, state);
+
+            if (cell->closed)
+                continue;
+
+            // Keep only the states that are not dominated by a state of the same block.
+            if (solver_table_dominated(table, state, (uint32_t) neighbor.accumulation_cost, drills_top))
+                continue;
+
+            solver_table_store(table, maze, neighbor, state_current);
+            queue_push(open, state, calculate_priority(w->order, neighbor, end));
+        }
+    }
+
+    /*
+     * Every record points to the state it has been reached from,
+     * so the path is rebuilt by walking back the parents.
+     * The length is counted first so the path is written
+     * directly in order, reusing the storage of @p out.
+     */
+    size_t length = 0;
+    for (uint32_t state = state_last; state != SOLVER_NO_PARENT; state = table->cells[state].parent)
+        length++;
+
+    cvector_reserve(*out, length);
+    cvector_set_size(*out, length);
+    for (uint32_t state = state_last; state != SOLVER_NO_PARENT; state = table->cells[state].parent)
+        (*out)[--length] = solver_table_location(w, maze, state, start, end);
+
+    return found;
+}
+
+static bool solver_has_drills(maze_t maze) {
+    for (int i = 0; i < maze.width * maze.height; ++i) {
+        if (maze.blocks[i] == SNAKE_DRILL_CHAR)
+            return true;
+    }
+
+    return false;
+}
+
+static uint32_t bidirectional_key(maze_t maze, location_t l, uint32_t cost, location_t target, location_t origin) {
+    /*
+     * Both searches use half the difference between the distance to
+     * their target and the distance from their origin, so the sum of the
+     * keys of the two sides is a lower bound of the paths not found yet.
+     * Keys are doubled to stay integers and shifted to stay positive.
+     */
+    return 2 * cost + calculate_distance(l, target) + maze.width + maze.height - calculate_distance(l, origin);
+}
+
+static void bidirectional_expand(solver_workspace_t *w, const solver_workspace_t *other, maze_t maze,
+                                 uint32_t state_current, location_t target, location_t origin, bool backward,
+                                 uint32_t *meeting, uint32_t *best) {
+    const solver_cell_t *current = &w->table.cells[state_current];
+    uint32_t index_current = state_current / SOLVER_LAYERS;
+    location_t l = {index_current % maze.width, index_current / maze.width};
+
+    /*
+     * Every step costs the block it enters, so the backward
+     * search pays the block it leaves instead of the reached one.
+     */
+    uint32_t leave_cost = backward ? (uint32_t) calculate_step(maze, l) : 0;
+
+    for (uint_fast8_t i = 1; i < 5; ++i) {
+        location_t neighbor = core_get_neighbor(l, i, 1);
+
+        if (!core_is_in_bounds(maze, neighbor))
+            continue;
+
+        if (*core_get_block_location(maze, neighbor) == SNAKE_WALL_CHAR)
+            continue;
+
+        uint32_t state = calculate_index(maze, neighbor) * SOLVER_LAYERS;
+        solver_cell_t *cell = solver_table_touch(&w->table, state);
+        uint32_t cost = current->cost + (backward ? leave_cost : (uint32_t) calculate_step(maze, neighbor));
+
+        if (cell->closed || cost >= cell->cost)
+            continue;
+
+        cell->parent = state_current;
+        cell->cost = cost;
+        cell->comes_from = neighbor.comes_from;
+        cell->dangers = 0;
+
+        // The best path is the cheapest one through a block reached by both searches.
+        const solver_cell_t *meet = &other->table.cells[state];
+        if (meet->generation == other->table.generation && cost + meet->cost < *best) {
+            *best = cost + meet->cost;
+            *meeting = state;
+        }
+
+        // Blocks that cannot lead to a cheaper path are never queued.
+        if (cost + calculate_distance(neighbor, target) >= *best)
+            continue;
+
+        queue_push(&w->open, state,
+                   queue_compose_priority(bidirectional_key(maze, neighbor, cost, target, origin), cost));
+    }
+}
+
+bool solver_execute_bidirectional_into(solver_workspace_t *forward, solver_workspace_t *backward, maze_t maze,
+                                       location_t start, location_t end, path_t *out) {
+    /*
+     * The backward search cannot know which drills will be collected
+     * before reaching a block, mazes with drills use a single a*.
+     */
+    if (start.drills > 0 || solver_has_drills(maze))
+        return solver_execute_astar_into(forward, maze, start, end, NULL, true, out);
+
+    uint32_t state_start = calculate_index(maze, start) * SOLVER_LAYERS;
+    uint32_t state_end = calculate_index(maze, end) * SOLVER_LAYERS;
+    uint32_t meeting = SOLVER_NO_PARENT, best = UINT32_MAX;
+    uint32_t floors[2];
+
+    solver_workspace_t *sides[2] = {forward, backward};
+    location_t targets[2] = {end, start};
+    uint32_t origins[2] = {state_start, state_end};
+
+    for (int side = 0; side < 2; ++side) {
+        solver_workspace_t *w = sides[side];
+        queue_clear(&w->open);
+        solver_table_next_generation(&w->table);
+
+        solver_cell_t *cell = solver_table_touch(&w->table, origins[side]);
+        cell->parent = SOLVER_NO_PARENT;
+        cell->cost = 0;
+        cell->comes_from = MOVE_EMPTY;
+        cell->dangers = 0;
+
+        floors[side] = bidirectional_key(maze, targets[1 - side], 0, targets[side], targets[1 - side]);
+        queue_push(&w->open, origins[side], queue_compose_priority(floors[side], 0));
+    }
+
+    if (state_start == state_end) {
+        best = 0;
+        meeting = state_start;
+    }
+
+    /*
+     * The side with the smaller open set is expanded first. The keys
+     * extracted by a side never decrease, so the sum of the last key
+     * extracted by both sides bounds every path not found yet: the search
+     * stops as soon as it reaches the cost of the best meeting block.
+     */
+    while (!queue_empty(&forward->open) && !queue_empty(&backward->open)) {
+        int side = forward->open.size <= backward->open.size ? 0 : 1;
+        solver_workspace_t *w = sides[side];
+
+        uint32_t state_current = queue_pop(&w->open);
+        uint32_t index_current = state_current / SOLVER_LAYERS;
+        location_t current = {index_current % maze.width, index_current / maze.width};
+        uint32_t cost = w->table.cells[state_current].cost;
+
+        floors[side] = bidirectional_key(maze, current, cost, targets[side], targets[1 - side]);
+        if (best != UINT32_MAX && floors[0] + floors[1] >= 2 * (best + maze.width + maze.height))
+            break;
+
+        w->table.cells[state_current].closed = true;
+
+        if (cost + calculate_distance(current, targets[side]) >= best)
+            continue;
+
+        // A block already expanded by the other side has been counted when the searches met.
+        const solver_cell_t *meet = &sides[1 - side]->table.cells[state_current];
+        if (meet->generation == sides[1 - side]->table.generation && meet->closed)
+            continue;
+
+        w->expanded++;
+        bidirectional_expand(w, sides[1 - side], maze, state_current, targets[side], targets[1 - side], side == 1,
+                             &meeting, &best);
+    }
+
+    if (meeting == SOLVER_NO_PARENT) {
+        cvector_set_size(*out, 0);
+        start.position_cost = calculate_step(maze, start);
+        start.accumulation_cost = 0;
+        start.dangers = 0;
+        cvector_push_back(*out, start);
+        return false;
+    }
+
+    /*
+     * The forward parents lead from the meeting block to start,
+     * the backward parents from the meeting block to end.
+     */
+    size_t length = 0, half;
+    for (uint32_t state = meeting; state != SOLVER_NO_PARENT; state = forward->table.cells[state].parent)
+        length++;
+
+    half = length;
+    for (uint32_t state = backward->table.cells[meeting].parent; state != SOLVER_NO_PARENT;
+         state = backward->table.cells[state].parent)
+        length++;
+
+    cvector_reserve(*out, length);
+    cvector_set_size(*out, length);
+
+    for (uint32_t state = meeting, i = half; state != SOLVER_NO_PARENT; state = forward->table.cells[state].parent)
+        (*out)[--i] = solver_table_location(forward, maze, state, start, end);
+
+    for (uint32_t state = backward->table.cells[meeting].parent, i = half; state != SOLVER_NO_PARENT;
+         state = backward->table.cells[state].parent, ++i) {
+        location_t *l = &(*out)[i];
+        uint32_t index = state / SOLVER_LAYERS;
+
+        *l = (*out)[i - 1];
+        l->x = index % maze.width;
+        l->y = index / maze.width;
+    }
+
+    // Costs and dangers are counted again from start, the backward records hold them towards end.
+    complete_path(maze, *out, 1);
+    return true;
+}
+
+path_t solver_execute_bidirectional(maze_t maze, location_t start, location_t end) {
+    solver_workspace_t forward, backward;
+    solver_init_workspace(&forward, maze);
+    solver_init_workspace(&backward, maze);
+
+    path_t path = NULL;
+    solver_execute_bidirectional_into(&forward, &backward, maze, start, end, &path);
+
+    solver_free_workspace(forward);
+    solver_free_workspace(backward);
+    return path;
+}
+
+static bool jps_open(maze_t maze, int x, int y) {
+    if (x < 0 || y < 0 || x >= maze.width || y >= maze.height)
+        return false;
+
+    return maze.blocks[x + y * maze.width] != SNAKE_WALL_CHAR;
+}
+
+static bool jps_clear(maze_t maze, int x, int y) {
+    // Dangers cost more than a step, for the shortest paths they are obstacles like the walls.
+    return jps_open(maze, x, y) && maze.blocks[x + y * maze.width] != SNAKE_DANGER_CHAR;
+}
+
+static bool jps_stop(maze_t maze, int x, int y, location_t end) {
+    maze_data_t block = maze.blocks[x + y * maze.width];
+
+    if (x == end.x && y == end.y)
+        return true;
+
+    return block == SNAKE_COIN_CHAR || block == SNAKE_DRILL_CHAR || block == SNAKE_DANGER_CHAR;
+}
+
+static bool jps_forced(maze_t maze, int x, int y, int dy) {
+    // A side opens right after a wall: the path may turn there.
+    for (int side = -1; side <= 1; side += 2) {
+        if (jps_open(maze, x + side, y) && !jps_clear(maze, x + side, y - dy))
+            return true;
+    }
+
+    return false;
+}
+
+static bool jps_jump_vertical(maze_t maze, int x, int y, int dy, location_t end, location_t *out) {
+    for (;;) {
+        y += dy;
+
+        if (!jps_open(maze, x, y))
+            return false;
+
+        out->x = x;
+        out->y = y;
+
+        if (jps_stop(maze, x, y, end) || jps_forced(maze, x, y, dy))
+            return true;
+    }
+}
+
+static bool jps_jump_horizontal(maze_t maze, int x, int y, int dx, location_t end, location_t *out) {
+    location_t ignored;
+
+    for (;;) {
+        x += dx;
+
+        if (!jps_open(maze, x, y))
+            return false;
+
+        out->x = x;
+        out->y = y;
+
+        if (jps_stop(maze, x, y, end))
+            return true;
+
+        // Rows are walked first, a block is a jump point when its columns lead to one.
+        if (jps_jump_vertical(maze, x, y, -1, end, &ignored) || jps_jump_vertical(maze, x, y, 1, end, &ignored))
+            return true;
+    }
+}
+
+static void jps_relax(solver_workspace_t *w, maze_t maze, uint32_t state_current, location_t current,
+                      location_t neighbor, move_t direction, uint32_t *drills_top, location_t end) {
+    solver_table_t *table = &w->table;
+    uint32_t index = calculate_index(maze, neighbor);
+
+    // Jumps never cross special blocks, only the reached one can change costs and drills.
+    neighbor.accumulation_cost = current.accumulation_cost + calculate_distance(current, neighbor) - 1 +
+                                 calculate_step(maze, neighbor);
+    neighbor.drills = current.drills;
+
+    switch (*core_get_block_location(maze, neighbor)) {
+        case SNAKE_DANGER_CHAR:
+            neighbor.dangers = current.dangers + 1;
+            break;
+        case SNAKE_DRILL_CHAR:
+            if (!solver_table_visited(table, state_current, index))
+                neighbor.drills += 3;
+
+            if (neighbor.drills > SOLVER_MAX_DRILLS)
+                neighbor.drills = SOLVER_MAX_DRILLS;
+
+            if (neighbor.drills > *drills_top)
+                *drills_top = (uint32_t) neighbor.drills;
+            break;
+        case SNAKE_WALL_CHAR:
+            if (neighbor.drills == 0)
+                return;
+
+            neighbor.drills--;
+            break;
+        default:
+            break;
+    }
+
+    uint32_t state = index * SOLVER_LAYERS + (uint32_t) neighbor.drills;
+    solver_cell_t *cell = solver_table_touch(table, state);
+
+    if (cell->closed || solver_table_dominated(table, state, (uint32_t) neighbor.accumulation_cost, *drills_top))
+        return;
+
+    /*
+     * Records of the jump search keep the direction of the last
+     * jump, MOVE_EMPTY when every direction has to be tried.
+     */
+    neighbor.comes_from = direction;
+    solver_table_store(table, maze, neighbor, state_current);
+    queue_push(&w->open, state, calculate_priority(SOLVER_ORDER_ASTAR, neighbor, end));
+}
+
+bool solver_execute_jps_into(solver_workspace_t *w, maze_t maze, location_t start, location_t end, path_t *out) {
+    bool found = false;
+    uint32_t index_end = calculate_index(maze, end);
+    uint32_t state_last, drills_top;
+
+    solver_table_t *table = &w->table;
+    queue_t *open = &w->open;
+
+    queue_clear(open);
+    solver_table_next_generation(table);
+
+    start.position_cost = calculate_step(maze, start);
+    start.accumulation_cost = 0;
+    start.drills = start.drills > SOLVER_MAX_DRILLS ? SOLVER_MAX_DRILLS : start.drills;
+    start.dangers = 0;
+    start.comes_from = MOVE_EMPTY;
+
+    drills_top = (uint32_t) start.drills;
+    state_last = calculate_state(maze, start);
+    solver_table_store(table, maze, start, SOLVER_NO_PARENT);
+    queue_push(open, state_last, calculate_priority(SOLVER_ORDER_ASTAR, start, end));
+    while (!queue_empty(open)) {
+        uint32_t state_current = queue_pop(open);
+        location_t current = solver_table_location(w, maze, state_current, start, end);
+        move_t direction = current.comes_from;
+
+        if (state_current / SOLVER_LAYERS == index_end) {
+            state_last = state_current;
+            found = true;
+            break;
+        }
+
+        table->cells[state_current].closed = true;
+
+        if (current.drills < drills_top &&
+            solver_table_dominated(table, state_current + 1, (uint32_t) current.accumulation_cost, drills_top))
+            continue;
+
+        w->expanded++;
+
+        /*
+         * With drills every wall can be crossed and jumps are not
+         * valid anymore: the neighbors are expanded one by one.
+         */
+        if (current.drills > 0) {
+            for (uint_fast8_t i = 1; i < 5; ++i) {
+                location_t neighbor = core_get_neighbor(current, i, 1);
+
+                if (core_is_in_bounds(maze, neighbor))
+                    jps_relax(w, maze, state_current, current, neighbor, MOVE_EMPTY, &drills_top, end);
+            }
+
+            continue;
+        }
+
+        // Special blocks are stops of the jumps, paths may leave them in every direction.
+        if (jps_stop(maze, current.x, current.y, end))
+            direction = MOVE_EMPTY;
+
+        for (uint_fast8_t i = 1; i < 5; ++i) {
+            bool horizontal = i == MOVE_LEFT || i == MOVE_RIGHT;
+            int delta = i == MOVE_LEFT || i == MOVE_TOP ? -1 : 1;
+
+            if (direction != MOVE_EMPTY && i == core_get_opposite_move(direction))
+                continue;
+
+            if (direction == MOVE_TOP || direction == MOVE_DOWN) {
+                // After a vertical jump a row is entered only when it is forced by a wall.
+                int dy = direction == MOVE_TOP ? -1 : 1;
+
+                if (horizontal && (!jps_open(maze, current.x + delta, current.y) ||
+                                   jps_clear(maze, current.x + delta, current.y - dy)))
+                    continue;
+            }
+
+            location_t neighbor = current;
+            bool jumped = horizontal ? jps_jump_horizontal(maze, current.x, current.y, delta, end, &neighbor)
+                                     : jps_jump_vertical(maze, current.x, current.y, delta, end, &neighbor);
+
+            if (jumped)
+                jps_relax(w, maze, state_current, current, neighbor, i, &drills_top, end);
+        }
+    }
+
+    /*
+     * Consecutive jump points share a row or a column,
+     * the blocks between them are filled back in the path.
+     */
+    size_t length = 1;
+    for (uint32_t state = state_last; table->cells[state].parent != SOLVER_NO_PARENT;
+         state = table->cells[state].parent) {
+        location_t to = solver_table_location(w, maze, state, start, end);
+        length += calculate_distance(solver_table_location(w, maze, table->cells[state].parent, start, end), to);
+    }
+
+    cvector_reserve(*out, length);
+    cvector_set_size(*out, length);
+
+    size_t i = length;
+    for (uint32_t state = state_last; state != SOLVER_NO_PARENT; state = table->cells[state].parent) {
+        location_t to = solver_table_location(w, maze, state, start, end);
+        (*out)[--i] = to;
+
+        if (table->cells[state].parent == SOLVER_NO_PARENT)
+            break;
+
+        location_t from = solver_table_location(w, maze, table->cells[state].parent, start, end);
+        move_t back = core_get_transition(to, from);
+
+        for (uint_fast16_t step = calculate_distance(from, to); step > 1; --step) {
+            to = core_get_neighbor(to, back, 1);
+            (*out)[--i] = to;
+        }
+    }
+
+    (*out)[0] = start;
+    complete_path(maze, *out, 1);
+    return found;
+}
+
+path_t solver_execute_jps(maze_t maze, location_t start, location_t end) {
+    solver_workspace_t w;
+    solver_init_workspace(&w, maze);
 
-    cvector_reverse(path);
+    path_t path = NULL;
+    solver_execute_jps_into(&w, maze, start, end, &path);
 
+    solver_free_workspace(w);
     return path;
 }
 
@@ -16,9 +16,14 @@
 #include "../core/core.h"
 #include "../configuration.h"
 #include "../vector/cvector.h"
+#include "../queue/queue.h"
+#include "../bitmap/bitmap.h"
+#include "../transposition/transposition.h"
 
 #include <math.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
 
 #ifndef PROGRAM_SOLVER_FULL_PRECISION
 /**
@@ -35,6 +40,88 @@
 #define PROGRAM_SOLVER_FULL_PRECISION false
 #endif
 
+/**
+ * @details Cost added to the step that enters a danger block.
+ *
+ * Dangers halve the collected coins so the searches
+ * avoid them unless they are the only way.
+ */
+#define SOLVER_DANGER_PENALTY 10000
+
+/**
+ * @brief Orderings of the a* open set.
+ *
+ * SOLVER_ORDER_ASTAR is the classic a*: every step costs 1
+ * plus SOLVER_DANGER_PENALTY when entering a danger, the heuristic
+ * is the manhattan distance to the end and ties are broken in favour
+ * of the deepest location. It returns shortest paths.
+ *
+ * SOLVER_ORDER_ACCUMULATED is the first ordering of the solver,
+ * the cost of a location is the sum of the distances to the end
+ * of every block of its path.
+ */
+typedef enum solver_order {
+    SOLVER_ORDER_ASTAR = 0, SOLVER_ORDER_ACCUMULATED = 1
+} solver_order_t;
+
+/**
+ * @brief Ordering keys of the frontier of the full solver.
+ *
+ * SOLVER_FRONTIER_COST expands first the path with the lowest
+ * accumulation cost, every step costs 2 and a coin gives back 1.
+ *
+ * SOLVER_FRONTIER_SCORE expands first the path with the best
+ * optimistic score: the coins collected minus the steps made
+ * and the manhattan distance still to walk to the end.
+ *
+ * SOLVER_FRONTIER_DEPTH expands first the deepest path, so
+ * complete paths are reached quickly (depth-first).
+ *
+ * On equal keys the path found first is expanded first.
+ */
+typedef enum solver_frontier_key {
+    SOLVER_FRONTIER_COST = 0, SOLVER_FRONTIER_SCORE = 1, SOLVER_FRONTIER_DEPTH = 2
+} solver_frontier_key_t;
+
+/**
+ * @brief Rankings of the paths kept by the beam search.
+ *
+ * SOLVER_BEAM_SCORE keeps the paths with the best score so far:
+ * ten times the coins held minus the steps made.
+ *
+ * SOLVER_BEAM_OPTIMISTIC adds to the score so far a bonus for the
+ * coins around the last block, every coin within SOLVER_BEAM_RADIUS
+ * steps is worth ten minus the steps to reach it and come back.
+ * The bonus is optimistic, coins already collected are still counted.
+ */
+typedef enum solver_beam_rank {
+    SOLVER_BEAM_SCORE = 0, SOLVER_BEAM_OPTIMISTIC = 1
+} solver_beam_rank_t;
+
+/**
+ * @details Manhattan distance of the coins counted
+ * by the SOLVER_BEAM_OPTIMISTIC bonus, a coin further
+ * away costs more steps than it's worth.
+ */
+#define SOLVER_BEAM_RADIUS 4
+
+/**
+ * @brief Struct that contains the counters of a run of the full solver.
+ */
+typedef struct solver_statistics {
+    uint_fast64_t expanded; /**< How many paths have been extracted from the frontier */
+    uint_fast64_t generated; /**< How many paths have been pushed in the frontier */
+    double estimation; /**< Wall time spent estimating the coins to collect */
+    double seconds; /**< Wall time spent expanding the paths, estimation excluded */
+    uint_fast64_t transposition_hits; /**< Paths dropped as their state was already reached in a better way */
+    uint_fast64_t transposition_misses; /**< Paths whose state has been stored in the transposition table */
+    uint_fast64_t transposition_overwrites; /**< Stored states that replaced a different one */
+    uint_fast64_t labels_dominated; /**< Paths dropped as their label was dominated on their block */
+    uint_fast64_t labels_removed; /**< Paths dropped from the frontier by a dominating label */
+    uint_fast64_t steals; /**< Paths taken from the frontier of another thread */
+    bool completed; /**< If the frontier has been exhausted, then a precise run found the best path */
+} solver_statistics_t;
+
 /**
  * @brief Typedef to create a vector of locations
  *
@@ -56,6 +143,331 @@ typedef cvector_vector_type(location_t) path_t;
  */
 typedef cvector_vector_type(path_t) paths_t;
 
+/**
+ * @brief Struct that represents a node of the search tree of the full solver.
+ *
+ * Every path expanded by @c solver_execute_full is a node that keeps
+ * its last location and the index of the node it has been expanded from,
+ * so the whole path is rebuilt walking back the parents.
+ */
+typedef struct solver_node {
+    uint64_t hash; /**< Zobrist hash of the state reached by the node */
+    uint32_t parent; /**< Index of the parent node, SOLVER_NO_PARENT for the root */
+    uint32_t depth; /**< How many locations are stored in the path of the node */
+    uint32_t accumulation_cost; /**< The cost of the path until this node */
+    uint16_t drills; /**< How many drills has been accumulated to this node */
+    uint16_t coins; /**< How many coins has been accumulated to this node */
+    uint16_t dangers; /**< How many dangers has been took to this node */
+    maze_data_t x, y; /**< Position of the block inside the maze */
+    uint8_t comes_from; /**< move_t that was made to reach this node */
+} solver_node_t;
+
+/**
+ * @brief Typedef to create a vector of nodes
+ *
+ * Uses the library cvector.h to define a new type
+ * and use it as a dynamic vector.
+ *
+ * Represents the arena where the nodes of a search
+ * tree are stored, nodes refer to each other by index.
+ * @see solver_node_t
+ */
+typedef cvector_vector_type(solver_node_t) solver_nodes_t;
+
+/**
+ * @brief Typedef to create the frontier of the full solver
+ *
+ * Uses the library cvector.h to define a new type
+ * and use it as a binary min-heap.
+ *
+ * Every element packs the ordering key of a node in the
+ * high bits and the index of the node in the low ones.
+ * @see solver_frontier_key_t
+ */
+typedef cvector_vector_type(queue_priority_t) solver_frontier_t;
+
+/**
+ * @details Most drills that a search state can hold.
+ *
+ * The searches run over (block, drills left) states, the drills
+ * above this value are ignored so every block has at most
+ * SOLVER_MAX_DRILLS + 1 states.
+ */
+#define SOLVER_MAX_DRILLS 6
+
+/**
+ * @details How many states every block has, one for every
+ * amount of drills in the range [0, SOLVER_MAX_DRILLS].
+ */
+#define SOLVER_LAYERS (SOLVER_MAX_DRILLS + 1)
+
+/**
+ * @details Parent of a record that has no predecessor,
+ * used by the starting block of a search.
+ */
+#define SOLVER_NO_PARENT UINT32_MAX
+
+/**
+ * @brief Struct that represents a search state.
+ *
+ * A state is a block reached with a certain amount of drills left,
+ * every block has SOLVER_LAYERS records stored next to each other and
+ * accessed by <tt>position * SOLVER_LAYERS + drills</tt>, where position
+ * is the linearized position of the block. Membership tests on the
+ * closed set and cost comparisons take constant time.
+ *
+ * A record is valid only when its generation matches the one
+ * of the table, older records are considered empty.
+ */
+typedef struct solver_cell {
+    uint32_t generation; /**< Search that wrote this record */
+    uint32_t cost; /**< Best cost found to reach the state */
+    uint32_t parent; /**< Index of the state this one has been reached from */
+    bool closed; /**< If the state has already been expanded */
+    uint8_t comes_from; /**< move_t made to reach the state with the best cost */
+    uint16_t dangers; /**< Dangers took when reaching the state with the best cost */
+} solver_cell_t;
+
+/**
+ * @brief Struct that represents the per-state records of a search.
+ *
+ * The table is sized maze.width * maze.height * SOLVER_LAYERS and reused
+ * between searches by increasing the generation instead of clearing it.
+ *
+ * The open position of a state is kept by the slots of the queue_t
+ * used as open set.
+ *
+ * @see solver_cell_t
+ */
+typedef struct solver_table {
+    solver_cell_t *cells; /**< Records of every state */
+    uint32_t generation; /**< Generation of the current search */
+    uint32_t size; /**< How many records are stored */
+} solver_table_t;
+
+/**
+ * @brief Struct that represents the last visit of a block by a replayed path.
+ *
+ * As for solver_cell_t, a record is valid only when its generation
+ * matches the one of the workspace.
+ */
+typedef struct solver_visit {
+    uint32_t generation; /**< Replay that wrote this record */
+    uint32_t move; /**< Move that reached the block the last time */
+} solver_visit_t;
+
+/**
+ * @details Value of solver_labels_t::next for a node
+ * whose label has been removed from its Pareto set.
+ */
+#define SOLVER_LABEL_DEAD (UINT32_MAX - 1)
+
+/**
+ * @brief Struct that contains the Pareto sets of labels of the full solver.
+ *
+ * The label of a node is its (steps, coins, drills) and the set of the coin
+ * and drill blocks it collected. A label dominates another one when it has
+ * no more steps, no fewer coins and no fewer drills and it collected a subset
+ * of the blocks of the other one, so every block that the other one can still
+ * collect is available to it too. Every block keeps the labels of the nodes
+ * that reached it and that are not dominated by any other one, as a list
+ * of nodes linked by @c next.
+ *
+ * A node whose label is removed is marked SOLVER_LABEL_DEAD
+ * and skipped when it leaves the frontier.
+ *
+ * The sets take one bit per coin and drill block for every node, the
+ * labels are kept only up to PROGRAM_SOLVER_PARETO_COLLECTABLES blocks.
+ */
+typedef struct solver_labels {
+    uint32_t *heads; /**< First node of the set of every block, SOLVER_NO_PARENT if empty */
+    uint32_t *bits; /**< Bit of every coin and drill block, SOLVER_NO_PARENT for the other blocks */
+    size_t words; /**< How many words are used by the collected set of a node */
+    cvector_vector_type(uint32_t) next; /**< Next node of the same set, indexed by node */
+    cvector_vector_type(uint64_t) sets; /**< Blocks collected by every node, @c words per node */
+} solver_labels_t;
+
+/**
+ * @brief Struct that contains the buffers used by a search.
+ *
+ * The buffers are sized on the maze when the workspace is
+ * initialized and reused by every search that receives it,
+ * so repeated searches don't allocate memory.
+ *
+ * A workspace must not be shared between threads, every
+ * thread should own its workspace.
+ */
+typedef struct solver_workspace {
+    solver_table_t table; /**< Records of every state */
+    queue_t open; /**< Open set of the search */
+    bitmap_t overlay; /**< Bitmap where the blocks to evict can be marked */
+    solver_order_t order; /**< Ordering of the open set, SOLVER_ORDER_ASTAR by default */
+    uint_fast64_t expanded; /**< How many locations have been expanded by the searches */
+    solver_visit_t *visits; /**< Last visit of every block, used by solver_collect_with */
+    uint32_t replay; /**< Generation of the current replay of solver_collect_with */
+} solver_workspace_t;
+
+/**
+ * @brief Struct that represents a thread of the parallel full solver.
+ *
+ * The nodes and the frontier are owned by the thread, other threads
+ * read them only while holding the lock to steal a path.
+ */
+typedef struct solver_worker {
+    pthread_t thread; /**< Thread running the worker */
+    bool started; /**< If the thread has been created */
+    pthread_mutex_t lock; /**< Guards the nodes and the frontier */
+    struct solver_parallel *shared; /**< State shared by every worker */
+    size_t id; /**< Index of the worker */
+    solver_nodes_t nodes; /**< Arena of the paths expanded by the worker */
+    solver_frontier_t open; /**< Local frontier */
+    solver_workspace_t w; /**< Workspace of the a* that completes the paths */
+    transposition_t table; /**< Local transposition table */
+    path_t shortest; /**< Tail found by a* */
+    uint32_t best_node; /**< Best path that reached the end, SOLVER_NO_PARENT if none */
+    int_fast32_t best_score; /**< Score of the best path */
+    solver_statistics_t counters; /**< Counters of the worker */
+} solver_worker_t;
+
+/**
+ * @brief Struct that contains the state shared by the threads of the parallel full solver.
+ *
+ * The fields after @c workers are accessed with atomic operations.
+ */
+typedef struct solver_parallel {
+    maze_t maze; /**< Maze where the paths are searched */
+    solver_frontier_key_t key; /**< Ordering of the frontiers */
+    zobrist_t keys; /**< Zobrist keys, read only */
+    uint_fast16_t total_coins; /**< Estimation of the coins to collect */
+    uint_fast16_t coin_blocks; /**< Coins on the maze, the most a path can collect */
+    const struct solver_control *control; /**< Deadline, precision and cancel flag of the search */
+    size_t threads; /**< Number of workers */
+    solver_worker_t *workers; /**< Workers, one per thread */
+    int_fast32_t incumbent; /**< Best score reached by any worker */
+    size_t active; /**< Workers that have paths to expand */
+    bool stop; /**< Set when the search has to stop */
+    bool completed; /**< Set when the search stops as every worker has run out of paths */
+} solver_parallel_t;
+
+/**
+ * @details Most threads used by solver_execute_parallel.
+ */
+#define SOLVER_MAX_THREADS 64
+
+/**
+ * @brief Allocates the buffers of a workspace
+ *
+ * Allocates space based on the size of the maze,
+ * the workspace can be used for every maze of the same size.
+ *
+ * Remember after using the workspace to free the allocated
+ * memory by calling solver_free_workspace.
+ *
+ * @param w Pointer to the workspace object
+ * @param maze Maze where the searches will be ran
+ */
+void solver_init_workspace(solver_workspace_t *w, maze_t maze)__attribute__((nonnull));
+
+/**
+ * @brief Selects the priority queue used by the workspace
+ *
+ * By default the workspace uses PROGRAM_SOLVER_QUEUE,
+ * the queue is reallocated only when @p kind is different.
+ *
+ * @see queue_kind_t
+ * @param w Pointer to the workspace object
+ * @param kind Backend of the open set
+ */
+void solver_set_workspace_queue(solver_workspace_t *w, queue_kind_t kind)__attribute__((nonnull));
+
+/**
+ * @brief Frees the workspace used space.
+ *
+ * @param w Workspace that needs to be deallocated
+ * @warning solver_init_workspace must be called before calling this function.
+ */
+void solver_free_workspace(solver_workspace_t w);
+
+/**
+ * @brief Callback invoked by @c solver_execute_anytime on every better path.
+ *
+ * The path is owned by the solver and is freed after the call,
+ * it must be copied to be kept.
+ *
+ * @param path The new best path, from start to end
+ * @param score Score of the path, as computed by solver_score
+ * @param context Pointer passed to solver_execute_anytime
+ */
+typedef void (*solver_improved_t)(path_t path, int_fast32_t score, void *context);
+
+/**
+ * @brief Struct that contains how a run of the full solver is controlled.
+ *
+ * @see solver_execute_controlled
+ */
+typedef struct solver_control {
+    double deadline; /**< Value of solver_now when the search stops */
+    bool precise; /**< Keeps searching after the estimated coins have been collected */
+    const bool *cancel; /**< The search stops when it becomes true, read atomically, can be NULL */
+    solver_improved_t improved; /**< Called on every better path, can be NULL */
+    void *context; /**< Passed to improved */
+} solver_control_t;
+
+/**
+ * @brief Returns the time of a monotonic clock.
+ *
+ * Measures wall time, the deadlines of the solvers are expressed on it.
+ *
+ * @return Seconds elapsed from an arbitrary point.
+ */
+double solver_now(void);
+
+/**
+ * @brief Checks if a run has to stop
+ *
+ * @param control How the run is controlled, NULL if it never stops
+ * @return True when the deadline has passed or the cancel flag is set.
+ */
+bool solver_expired(const solver_control_t *control);
+
+/**
+ * @brief Counts what is collected walking a path
+ *
+ * Sets on every location the coins, drills and dangers held after
+ * reaching it, with the rules of the game. Every block is collected
+ * the first time it's walked, then it's empty: a danger cuts the body
+ * of the snake to its longer half. The body covers the blocks walked
+ * in the last moves, one for every coin, and moving on it cuts the
+ * body there, so the coins are the blocks walked after the hit one.
+ *
+ * @param maze Maze where the path is walked
+ * @param path Path that starts from the start
+ */
+void solver_collect(maze_t maze, path_t path);
+
+/**
+ * @brief Counts what is collected walking a path
+ *
+ * Works as solver_collect, the visits of the blocks are stamped
+ * on the workspace so repeated replays don't allocate memory.
+ *
+ * @param w Workspace sized on @p maze
+ * @param maze Maze where the path is walked
+ * @param path Path that starts from the start
+ */
+void solver_collect_with(solver_workspace_t *w, maze_t maze, path_t path)__attribute__((nonnull(1)));
+
+/**
+ * @brief Returns the score of a path.
+ *
+ * Every move costs one point and every coin held at
+ * the end is worth ten, repeated locations are not moves.
+ *
+ * @param path Path from start to end
+ * @return The score, INT_FAST32_MIN if the path is empty.
+ */
+int_fast32_t solver_score(path_t path);
+
 /**
  * @brief Function that runs the full algorithm
  *
@@ -69,11 +481,125 @@ typedef cvector_vector_type(path_t) paths_t;
  */
 path_t solver_execute_full(maze_t maze);
 
+/**
+ * @brief Runs the full algorithm with a custom frontier
+ *
+ * Works exactly in the same way as @c solver_execute_full but the
+ * open paths are ordered by @p key, @c solver_execute_full uses
+ * PROGRAM_SOLVER_FRONTIER. The frontier is a binary heap, so the next
+ * path is extracted in O(log n) instead of scanning every open path.
+ *
+ * When @p statistics is not NULL the counters of the run are written there,
+ * the node throughput is <tt>expanded / seconds</tt>.
+ *
+ * @see solver_execute_full
+ * @param maze Maze where the algorithm has to be ran
+ * @param key Ordering of the open paths
+ * @param statistics Where the counters are written, can be NULL
+ * @return Null if there is no path or a vector of locations to reach end from start.
+ */
+path_t solver_execute_full_with(maze_t maze, solver_frontier_key_t key, solver_statistics_t *statistics);
+
+/**
+ * @brief Runs the full algorithm until a deadline
+ *
+ * Works as @c solver_execute_full but the search stops when the
+ * monotonic clock reaches @p deadline, returning the best path found
+ * so far. A shortest path to the end is found before the search starts,
+ * so every run has a path to return when the end can be reached.
+ *
+ * @p improved is called with the first path and then every time
+ * a path with a higher score is found.
+ *
+ * @see solver_now
+ * @param maze Maze where the algorithm has to be ran
+ * @param deadline Value of solver_now when the search stops
+ * @param improved Called on every better path, can be NULL
+ * @param context Passed to @p improved
+ * @param statistics Where the counters are written, can be NULL
+ * @return Null if there is no path or a vector of locations to reach end from start.
+ */
+path_t solver_execute_anytime(maze_t maze, double deadline, solver_improved_t improved, void *context,
+                              solver_statistics_t *statistics);
+
+/**
+ * @brief Runs the full algorithm controlled by the caller
+ *
+ * Works as @c solver_execute_anytime, the full precision and the
+ * cancellation are chosen by @p control instead of the configuration.
+ *
+ * @param maze Maze where the algorithm has to be ran
+ * @param control How the search is ran
+ * @param statistics Where the counters are written, can be NULL
+ * @return Null if there is no path or a vector of locations to reach end from start.
+ */
+path_t solver_execute_controlled(maze_t maze, solver_control_t *control,
+                                 solver_statistics_t *statistics)__attribute__((nonnull(2)));
+
+/**
+ * @brief Runs the full algorithm on many threads
+ *
+ * Every thread expands the paths of its own frontier, ordered by
+ * PROGRAM_SOLVER_FRONTIER, and when its frontier is empty it steals
+ * the best path of the frontier of another thread. The best score
+ * reached by any thread is shared and the paths that can't beat it,
+ * even collecting every coin of the maze, are dropped.
+ *
+ * Paths follow the same rules of @c solver_execute_controlled, the
+ * search stops at the deadline of @p control, when its cancel flag is
+ * set or, unless precise, when a path collects the estimated coins.
+ * The improved callback is not called. The Pareto labels are not used,
+ * every thread has its own transposition table.
+ *
+ * When no thread can be created the first worker runs on the calling one.
+ *
+ * @param maze Maze where the algorithm has to be ran
+ * @param threads How many threads are started, between 1 and SOLVER_MAX_THREADS
+ * @param control How the search is stopped
+ * @param statistics Where the counters of every thread are summed, can be NULL
+ * @return Null if there is no path or a vector of locations to reach end from start.
+ */
+path_t solver_execute_parallel(maze_t maze, size_t threads, solver_control_t *control,
+                               solver_statistics_t *statistics)__attribute__((nonnull(3)));
+
+/**
+ * @brief Runs a beam search of the best path
+ *
+ * Paths are grown one step at a time and after every step
+ * only the best @p width of them, ranked by @p rank, are kept.
+ * The result is not proven optimal but the nodes stored are at most
+ * <tt>width * length</tt> and the time grows linearly with @p width.
+ *
+ * Paths follow the same rules of @c solver_execute_full: a path never
+ * walks back on its blocks and ends as soon as it reaches the end.
+ *
+ * The steps stop at the deadline of @p control or when its cancel flag
+ * is set, the best path that reached the end until then is returned.
+ *
+ * When @p statistics is not NULL the counters of the run are written there.
+ *
+ * @param maze Maze where the algorithm has to be ran
+ * @param width How many paths are kept after every step, at least 1
+ * @param rank Ranking of the paths
+ * @param control How the search is stopped, NULL to run until the end
+ * @param statistics Where the counters are written, can be NULL
+ * @return Null if there is no path or a vector of locations to reach end from start.
+ */
+path_t solver_execute_beam(maze_t maze, size_t width, solver_beam_rank_t rank, const solver_control_t *control,
+                           solver_statistics_t *statistics);
+
 /**
  * @brief Runs the base a* algorithm
  *
  * Simple and fast implementation of the a* algorithm.
  *
+ * The search runs over (block, drills left) states: a block reached
+ * with more drills is a different state, so walls are drilled only
+ * when it pays off. A state is dropped when the same block has been
+ * reached with at least as many drills at an equal or lower cost.
+ * The drills of @p start are used, up to SOLVER_MAX_DRILLS, and every
+ * drill block is collected at most once per path.
+ *
  * @param maze Maze where to execute a*
  * @param start Starting point
  * @param end Ending point
@@ -83,4 +609,160 @@ path_t solver_execute_full(maze_t maze);
  */
 path_t solver_execute_astar(maze_t maze, location_t start, location_t end, path_t overlay, bool go_back);
 
+/**
+ * @brief Runs the base a* algorithm evicting the marked blocks
+ *
+ * Works exactly in the same way as @c solver_execute_astar
+ * but the blocks to evict are already marked on a bitmap,
+ * indexed by the linearized position of the blocks.
+ *
+ * Useful when the same overlay is used by more searches.
+ *
+ * @see solver_execute_astar
+ * @param maze Maze where to execute a*
+ * @param start Starting point
+ * @param end Ending point
+ * @param overlay Bitmap of the blocks to evict, can be NULL
+ * @param go_back Search a straight-only path
+ * @return A vector of locations to reach end from start.
+ */
+path_t solver_execute_astar_masked(maze_t maze, location_t start, location_t end, const bitmap_t *overlay,
+                                   bool go_back);
+
+/**
+ * @brief Runs the base a* algorithm inside a workspace
+ *
+ * Works exactly in the same way as @c solver_execute_astar_masked
+ * but uses the buffers of @p w and writes the path in @p out,
+ * reusing its storage. When the workspace and the path are reused
+ * no memory is allocated.
+ *
+ * If @p end cannot be reached @p out will contain only @p start.
+ *
+ * @see solver_execute_astar_masked
+ * @param w Workspace used by the search
+ * @param maze Maze where to execute a*
+ * @param start Starting point
+ * @param end Ending point
+ * @param overlay Bitmap of the blocks to evict, can be NULL
+ * @param go_back Search a straight-only path
+ * @param out Pointer to the path where the result is written
+ * @return True if @p end has been reached.
+ */
+bool solver_execute_astar_into(solver_workspace_t *w, maze_t maze, location_t start, location_t end,
+                               const bitmap_t *overlay, bool go_back, path_t *out)__attribute__((nonnull(1, 7)));
+
+/**
+ * @brief Runs a bidirectional a* from start to end
+ *
+ * Two searches are ran at the same time, one from @p start
+ * and one backwards from @p end, always expanding the one with
+ * the smaller open set. The search stops when the lowest f of the
+ * expanded side reaches the cost of the best block reached by both,
+ * so the returned path is as short as the one of @c solver_execute_astar.
+ *
+ * The backward search cannot know how many drills are collected before
+ * a block, when the maze contains drills a single a* is ran instead.
+ *
+ * Remember after using the path to free it.
+ *
+ * @see solver_execute_bidirectional_into
+ * @param maze Maze where to execute the search
+ * @param start Starting point
+ * @param end Ending point
+ * @return A vector of locations to reach end from start.
+ */
+path_t solver_execute_bidirectional(maze_t maze, location_t start, location_t end);
+
+/**
+ * @brief Runs a bidirectional a* inside two workspaces
+ *
+ * Works exactly in the same way as @c solver_execute_bidirectional
+ * but uses the buffers of @p forward and @p backward and writes
+ * the path in @p out, reusing its storage.
+ *
+ * If @p end cannot be reached @p out will contain only @p start.
+ *
+ * @see solver_execute_bidirectional
+ * @param forward Workspace used by the search from @p start
+ * @param backward Workspace used by the search from @p end
+ * @param maze Maze where to execute the search
+ * @param start Starting point
+ * @param end Ending point
+ * @param out Pointer to the path where the result is written
+ * @return True if @p end has been reached.
+ */
+bool solver_execute_bidirectional_into(solver_workspace_t *forward, solver_workspace_t *backward, maze_t maze,
+                                       location_t start, location_t end, path_t *out)__attribute__((nonnull(1, 2, 6)));
+
+/**
+ * @brief Runs a jump point search from start to end
+ *
+ * Variant of a* for 4-connected grids that jumps along rows and
+ * columns, queueing only the blocks where a shortest path may turn:
+ * rows are walked first and a column is left only when a wall forces it.
+ * Open rooms are crossed with few expansions.
+ *
+ * Coins, drills and dangers stop the jumps so every special block
+ * of the path is a jump point. Once a drill is collected every wall
+ * can be crossed, so the states with drills expand their neighbors
+ * one by one like @c solver_execute_astar.
+ *
+ * Remember after using the path to free it.
+ *
+ * @see solver_execute_jps_into
+ * @param maze Maze where to execute the search
+ * @param start Starting point
+ * @param end Ending point
+ * @return A vector of locations to reach end from start.
+ */
+path_t solver_execute_jps(maze_t maze, location_t start, location_t end);
+
+/**
+ * @brief Runs a jump point search inside a workspace
+ *
+ * Works exactly in the same way as @c solver_execute_jps
+ * but uses the buffers of @p w and writes the path in @p out,
+ * reusing its storage. The blocks skipped by the jumps are
+ * filled back so @p out contains every block of the path.
+ *
+ * If @p end cannot be reached @p out will contain only @p start.
+ *
+ * @see solver_execute_jps
+ * @param w Workspace used by the search
+ * @param maze Maze where to execute the search
+ * @param start Starting point
+ * @param end Ending point
+ * @param out Pointer to the path where the result is written
+ * @return True if @p end has been reached.
+ */
+bool solver_execute_jps_into(solver_workspace_t *w, maze_t maze, location_t start, location_t end,
+                             path_t *out)__attribute__((nonnull(1, 5)));
+
+/**
+ * @brief Runs a breadth-first search on the blocks of a maze
+ *
+ * Walks from @p origin every block that is not a wall, without
+ * drilling. The block @p avoid is reached but never crossed,
+ * unless it's the origin. Without @p dangers a danger is walked
+ * only when @p empty is given and no coin has been collected
+ * on the way to it, as halving an empty body takes nothing.
+ *
+ * The reached blocks are written in @p queue in the order they are
+ * visited, so the parent of every block comes before it.
+ *
+ * @param maze Maze where to execute the search
+ * @param origin Block where the search starts
+ * @param avoid Block that is never crossed, SOLVER_NO_PARENT if none
+ * @param dangers If the dangers can be walked
+ * @param parents Parent of every block, SOLVER_NO_PARENT if unreachable, can be NULL
+ * @param distances Steps to reach every block, UINT32_MAX if unreachable, can be NULL
+ * @param queue Array able to hold every block
+ * @param empty If every block is reached without coins, can be NULL
+ * @return How many blocks have been reached.
+ * @warning At least one of @p parents and @p distances must be given.
+ */
+size_t solver_execute_field(maze_t maze, uint32_t origin, uint32_t avoid, bool dangers, uint32_t *parents,
+                            uint32_t *distances, uint32_t *queue, uint8_t *empty)__attribute__((nonnull(7)));
+
 #endif //SNAKE_SOLVER_H
@@ -0,0 +1,623 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "tour.h"
+
+static uint32_t tour_index(maze_t maze, location_t l) {
+    return (uint32_t) l.x + (uint32_t) l.y * maze.width;
+}
+
+static int tour_compare_candidates(const void *a, const void *b) {
+    uint64_t first = *(const uint64_t *) a, second = *(const uint64_t *) b;
+    return (first > second) - (first < second);
+}
+
+void tour_init_matrix(tour_matrix_t *matrix, maze_t maze) {
+    size_t cells = (size_t) maze.width * maze.height;
+    uint32_t start = tour_index(maze, maze.start), end = tour_index(maze, maze.end);
+
+    // Drills are not used by the tour, walls are never crossed.
+    matrix->view = core_duplicate_maze(maze);
+    for (size_t i = 0; i < cells; ++i) {
+        if (matrix->view.blocks[i] == SNAKE_DRILL_CHAR)
+            matrix->view.blocks[i] = ' ';
+    }
+
+    uint32_t *from_start = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *from_end = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *field = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint32_t *queue = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+
+    // The game ends on the end, so it can only be the last block of a leg.
+    solver_execute_field(matrix->view, start, end, false, NULL, from_start, queue, NULL);
+    solver_execute_field(matrix->view, end, end, false, NULL, from_end, queue, NULL);
+
+    /*
+     * Coins are sorted by the detour they add to the shortest
+     * path from start to end, only the cheapest ones are kept.
+     */
+    cvector_vector_type(uint64_t) candidates = NULL;
+    for (size_t i = 0; i < cells; ++i) {
+        if (maze.blocks[i] != SNAKE_COIN_CHAR)
+            continue;
+
+        if (from_start[i] == TOUR_UNREACHABLE || from_end[i] == TOUR_UNREACHABLE)
+            continue;
+
+        uint64_t detour = (uint64_t) from_start[i] + from_end[i];
+        cvector_push_back(candidates, detour << 32 | i);
+    }
+
+    if (candidates)
+        qsort(candidates, cvector_size(candidates), sizeof(uint64_t), tour_compare_candidates);
+
+    size_t coins = cvector_size(candidates) < TOUR_MAX_COINS ? cvector_size(candidates) : TOUR_MAX_COINS;
+
+    matrix->points = NULL;
+    matrix->size = coins + 2;
+    matrix->distances = (uint32_t *) PROGRAM_MALLOC(matrix->size * matrix->size * sizeof(uint32_t));
+
+    cvector_push_back(matrix->points, maze.start);
+    for (size_t i = 0; i < coins; ++i) {
+        uint32_t position = (uint32_t) candidates[i];
+        location_t coin = {position % maze.width, position / maze.width};
+        cvector_push_back(matrix->points, coin);
+    }
+    cvector_push_back(matrix->points, maze.end);
+
+    /*
+     * The coins are nodes of the junction graph, when the corridors
+     * make it much smaller than the maze the distances of the coins
+     * are measured on its edges instead of on the blocks.
+     */
+    size_t open = 0;
+    for (size_t i = 0; i < cells; ++i)
+        open += matrix->view.blocks[i] != SNAKE_WALL_CHAR;
+
+    graph_t *graph = &matrix->graph;
+    graph_init(graph, matrix->view, true);
+
+    bool contracted = matrix->contracted = (size_t) graph->count * TOUR_GRAPH_CONTRACTION <= open;
+    queue_t nodes;
+
+    if (contracted)
+        queue_init(&nodes, graph->count, PROGRAM_SOLVER_QUEUE);
+
+    for (size_t i = 0; i < matrix->size; ++i) {
+        const uint32_t *distances = field;
+        bool on_graph = false;
+
+        if (i == 0) {
+            distances = from_start;
+        } else if (i + 1 == matrix->size) {
+            distances = from_end;
+        } else if (contracted) {
+            graph_distances(graph, matrix->view, false, graph->nodes[tour_index(maze, matrix->points[i])], field, NULL,
+                            &nodes);
+            on_graph = true;
+        } else {
+            solver_execute_field(matrix->view, tour_index(maze, matrix->points[i]), end, false, NULL, field, queue,
+                                 NULL);
+        }
+
+        for (size_t j = 0; j < matrix->size; ++j) {
+            uint32_t block = tour_index(maze, matrix->points[j]);
+            tour_distance(matrix, i, j) = distances[on_graph ? graph->nodes[block] : block];
+        }
+    }
+
+    if (contracted)
+        queue_free(nodes);
+
+    cvector_free(candidates);
+    PROGRAM_FREE(from_start);
+    PROGRAM_FREE(from_end);
+    PROGRAM_FREE(field);
+    PROGRAM_FREE(queue);
+}
+
+void tour_free_matrix(tour_matrix_t matrix) {
+    core_free_maze(matrix.view);
+    cvector_free(matrix.points);
+    PROGRAM_FREE(matrix.distances);
+    graph_free(matrix.graph);
+}
+
+static tour_t tour_solve_exact(const tour_matrix_t *matrix) {
+    /*
+     * Held-Karp: length[mask][i] is the shortest walk from the start
+     * that collects the coins of mask and stops on the coin i.
+     * Every walk is closed with the distance to the end and the
+     * one with the highest value is taken.
+     */
+    uint32_t coins = (uint32_t) matrix->size - 2, last = (uint32_t) matrix->size - 1;
+    size_t masks = (size_t) 1 << coins;
+    uint32_t *length = (uint32_t *) PROGRAM_MALLOC(masks * (coins + 1) * sizeof(uint32_t));
+
+    memset(length, 0xFF, masks * (coins + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < coins; ++i)
+        length[((size_t) 1 << i) * coins + i] = tour_distance(matrix, 0, i + 1);
+
+    int_fast64_t best = -(int_fast64_t) tour_distance(matrix, 0, last);
+    size_t best_mask = 0;
+    uint32_t best_coin = 0;
+
+    for (size_t mask = 1; mask < masks; ++mask) {
+        int_fast64_t value = (int_fast64_t) __builtin_popcountll(mask) * TOUR_COIN_VALUE;
+
+        for (uint32_t i = 0; i < coins; ++i) {
+            uint32_t current = length[mask * coins + i];
+
+            if (!(mask >> i & 1) || current == TOUR_UNREACHABLE)
+                continue;
+
+            uint32_t closing = tour_distance(matrix, i + 1, last);
+            if (closing != TOUR_UNREACHABLE && value - current - closing > best) {
+                best = value - current - closing;
+                best_mask = mask;
+                best_coin = i;
+            }
+
+            for (uint32_t j = 0; j < coins; ++j) {
+                uint32_t step = tour_distance(matrix, i + 1, j + 1);
+
+                if (mask >> j & 1 || step == TOUR_UNREACHABLE)
+                    continue;
+
+                uint32_t *next = &length[(mask | (size_t) 1 << j) * coins + j];
+                if (current + step < *next)
+                    *next = current + step;
+            }
+        }
+    }
+
+    // The walk is rebuilt backwards, looking for the coin that produced every length.
+    tour_t tour = NULL;
+    cvector_push_back(tour, last);
+
+    size_t mask = best_mask;
+    uint32_t coin = best_coin;
+    while (mask) {
+        size_t previous = mask & ~((size_t) 1 << coin);
+        uint32_t current = length[mask * coins + coin];
+
+        cvector_push_back(tour, coin + 1);
+        mask = previous;
+
+        for (uint32_t k = 0; k < coins && previous; ++k) {
+            uint32_t before = length[previous * coins + k];
+
+            if (previous >> k & 1 && before != TOUR_UNREACHABLE &&
+                before + tour_distance(matrix, k + 1, coin + 1) == current) {
+                coin = k;
+                break;
+            }
+        }
+    }
+
+    cvector_push_back(tour, 0);
+    for (size_t i = 0, j = cvector_size(tour) - 1; i < j; ++i, --j) {
+        uint32_t t = tour[i];
+        tour[i] = tour[j];
+        tour[j] = t;
+    }
+
+    PROGRAM_FREE(length);
+    return tour;
+}
+
+static uint32_t tour_insertion_cost(const tour_matrix_t *matrix, uint32_t from, uint32_t to, uint32_t point) {
+    uint32_t before = tour_distance(matrix, from, point), after = tour_distance(matrix, point, to);
+
+    if (before == TOUR_UNREACHABLE || after == TOUR_UNREACHABLE)
+        return TOUR_UNREACHABLE;
+
+    return before + after - tour_distance(matrix, from, to);
+}
+
+static tour_t tour_solve_insertion(const tour_matrix_t *matrix) {
+    /*
+     * Cheapest insertion: the tour starts as start -> end and the coin
+     * that adds the fewest steps is inserted until no coin is worth
+     * its detour. Every coin caches its cheapest edge, only the coins
+     * whose edge has been split are measured again on the whole tour.
+     */
+    uint32_t size = (uint32_t) matrix->size, last = size - 1;
+    uint32_t *next = (uint32_t *) PROGRAM_MALLOC(size * sizeof(uint32_t));
+    uint32_t *edge = (uint32_t *) PROGRAM_MALLOC(size * sizeof(uint32_t));
+    uint32_t *cost = (uint32_t *) PROGRAM_MALLOC(size * sizeof(uint32_t));
+
+    memset(next, 0xFF, size * sizeof(uint32_t));
+    next[0] = last;
+
+    for (uint32_t point = 1; point < last; ++point) {
+        edge[point] = 0;
+        cost[point] = tour_insertion_cost(matrix, 0, last, point);
+    }
+
+    for (;;) {
+        uint32_t chosen = 0;
+
+        for (uint32_t point = 1; point < last; ++point) {
+            if (next[point] == TOUR_UNREACHABLE && (chosen == 0 || cost[point] < cost[chosen]))
+                chosen = point;
+        }
+
+        if (chosen == 0 || cost[chosen] >= TOUR_COIN_VALUE)
+            break;
+
+        uint32_t from = edge[chosen], to = next[from];
+        next[from] = chosen;
+        next[chosen] = to;
+
+        for (uint32_t point = 1; point < last; ++point) {
+            if (next[point] != TOUR_UNREACHABLE)
+                continue;
+
+            if (edge[point] == from) {
+                // The cached edge doesn't exist anymore.
+                cost[point] = TOUR_UNREACHABLE;
+                for (uint32_t a = 0; a != last; a = next[a]) {
+                    uint32_t c = tour_insertion_cost(matrix, a, next[a], point);
+
+                    if (c < cost[point]) {
+                        cost[point] = c;
+                        edge[point] = a;
+                    }
+                }
+            } else {
+                uint32_t before = tour_insertion_cost(matrix, from, chosen, point);
+                uint32_t after = tour_insertion_cost(matrix, chosen, to, point);
+
+                if (before < cost[point]) {
+                    cost[point] = before;
+                    edge[point] = from;
+                }
+
+                if (after < cost[point]) {
+                    cost[point] = after;
+                    edge[point] = chosen;
+                }
+            }
+        }
+    }
+
+    tour_t tour = NULL;
+    for (uint32_t point = 0; point != last; point = next[point])
+        cvector_push_back(tour, point);
+    cvector_push_back(tour, last);
+
+    PROGRAM_FREE(next);
+    PROGRAM_FREE(edge);
+    PROGRAM_FREE(cost);
+    return tour;
+}
+
+tour_t tour_solve(const tour_matrix_t *matrix) {
+    if (tour_distance(matrix, 0, matrix->size - 1) == TOUR_UNREACHABLE)
+        return NULL;
+
+    if (matrix->size - 2 <= TOUR_EXACT_COINS)
+        return tour_solve_exact(matrix);
+
+    return tour_solve_insertion(matrix);
+}
+
+static bool tour_graph_leg(const tour_matrix_t *matrix, maze_t maze, location_t from, location_t to, bitmap_t evicted,
+                           path_t *leg) {
+    // The shortest leg on the edges, kept only when none of its blocks is evicted.
+    const graph_t *graph = &matrix->graph;
+    path_t shortest = graph_execute_shortest(graph, matrix->view, false, graph->nodes[tour_index(maze, from)],
+                                             graph->nodes[tour_index(maze, to)]);
+    bool found = shortest != NULL;
+
+    for (size_t i = 1; found && i < cvector_size(shortest); ++i)
+        found = !bitmap_test(evicted, tour_index(maze, shortest[i]));
+
+    if (found) {
+        cvector_free(*leg);
+        *leg = shortest;
+    } else {
+        cvector_free(shortest);
+    }
+
+    return found;
+}
+
+path_t tour_stitch(const tour_matrix_t *matrix, maze_t maze, tour_t tour, const solver_control_t *control) {
+    size_t cells = (size_t) maze.width * maze.height;
+    path_t path = NULL, leg = NULL;
+    solver_workspace_t w;
+    bitmap_t walked, evicted;
+
+    solver_init_workspace(&w, matrix->view);
+    bitmap_init(&walked, cells);
+    bitmap_init(&evicted, cells);
+
+    // Only the last leg can step on the end, no leg steps on the body.
+    bitmap_set(evicted, tour_index(maze, maze.end));
+
+    location_t current = matrix->points[0];
+    cvector_push_back(path, current);
+
+    for (size_t k = 1; k < cvector_size(tour); ++k) {
+        location_t target = matrix->points[tour[k]];
+        bool last = k + 1 == cvector_size(tour);
+
+        // The coin has been collected by a previous leg, or there's no time left for it.
+        if (!last && (bitmap_test(walked, tour_index(maze, target)) || solver_expired(control)))
+            continue;
+
+        /*
+         * The blocks under the body are evicted, walking back on them
+         * would cut it. When the target can only be reached through the
+         * body, as at the end of a dead end, the leg crosses it.
+         */
+        solver_collect_with(&w, maze, path);
+        size_t size = cvector_size(path), body = cvector_last(path)->coins;
+
+        for (size_t i = size - 1 - body; i + 1 < size; ++i)
+            bitmap_set(evicted, tour_index(maze, path[i]));
+
+        if (last)
+            bitmap_reset(evicted, tour_index(maze, maze.end));
+
+        bool found = matrix->contracted && tour_graph_leg(matrix, maze, current, target, evicted, &leg);
+
+        if (!found)
+            found = solver_execute_astar_into(&w, matrix->view, current, target, &evicted, true, &leg);
+
+        for (size_t i = size - 1 - body; i + 1 < size; ++i)
+            bitmap_reset(evicted, tour_index(maze, path[i]));
+
+        bitmap_set(evicted, tour_index(maze, maze.end));
+
+        if (!found)
+            solver_execute_astar_into(&w, matrix->view, current, target, last ? NULL : &evicted, true, &leg);
+
+        for (size_t i = 1; i < cvector_size(leg); ++i) {
+            cvector_push_back(path, leg[i]);
+            bitmap_set(walked, tour_index(maze, leg[i]));
+        }
+
+        current = target;
+    }
+
+    solver_collect_with(&w, maze, path);
+
+    cvector_free(leg);
+    bitmap_free(walked);
+    bitmap_free(evicted);
+    solver_free_workspace(w);
+    return path;
+}
+
+tour_t tour_extract(const tour_matrix_t *matrix, maze_t maze, path_t path) {
+    size_t cells = (size_t) maze.width * maze.height;
+    uint32_t last = (uint32_t) matrix->size - 1;
+    uint32_t *points = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+
+    memset(points, 0xFF, cells * sizeof(uint32_t));
+    for (uint32_t point = 1; point < last; ++point)
+        points[tour_index(maze, matrix->points[point])] = point;
+
+    tour_t tour = NULL;
+    cvector_push_back(tour, 0);
+
+    for (size_t i = 0; i < cvector_size(path); ++i) {
+        uint32_t *point = &points[tour_index(maze, path[i])];
+
+        if (*point == TOUR_UNREACHABLE)
+            continue;
+
+        cvector_push_back(tour, *point);
+        *point = TOUR_UNREACHABLE;
+    }
+
+    cvector_push_back(tour, last);
+
+    PROGRAM_FREE(points);
+    return tour;
+}
+
+static int_fast64_t tour_step(const tour_matrix_t *matrix, uint32_t from, uint32_t to) {
+    // An unreachable step is so long that no move ever uses it.
+    uint32_t distance = tour_distance(matrix, from, to);
+    return distance == TOUR_UNREACHABLE ? INT32_MAX : (int_fast64_t) distance;
+}
+
+static bool tour_remove(const tour_matrix_t *matrix, tour_t tour, bool *used) {
+    for (size_t i = 1; i + 1 < cvector_size(tour); ++i) {
+        int_fast64_t saved = tour_step(matrix, tour[i - 1], tour[i]) + tour_step(matrix, tour[i], tour[i + 1]) -
+                             tour_step(matrix, tour[i - 1], tour[i + 1]);
+
+        if (saved > TOUR_COIN_VALUE) {
+            used[tour[i]] = false;
+            cvector_erase(tour, i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool tour_insert(const tour_matrix_t *matrix, tour_t *tour, bool *used) {
+    for (uint32_t point = 1; point + 1 < matrix->size; ++point) {
+        if (used[point])
+            continue;
+
+        int_fast64_t cheapest = TOUR_COIN_VALUE;
+        size_t position = 0;
+
+        for (size_t i = 0; i + 1 < cvector_size(*tour); ++i) {
+            uint32_t from = (*tour)[i], to = (*tour)[i + 1];
+            int_fast64_t cost = tour_step(matrix, from, point) + tour_step(matrix, point, to) -
+                                tour_step(matrix, from, to);
+
+            if (cost < cheapest) {
+                cheapest = cost;
+                position = i + 1;
+            }
+        }
+
+        if (position > 0) {
+            used[point] = true;
+            cvector_insert(*tour, position, point);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool tour_two_opt(const tour_matrix_t *matrix, tour_t tour) {
+    // The distances are symmetric, so the inside of a reversed segment keeps its length.
+    size_t size = cvector_size(tour);
+
+    for (size_t i = 1; i + 2 < size; ++i) {
+        for (size_t j = i + 1; j + 1 < size; ++j) {
+            int_fast64_t delta = tour_step(matrix, tour[i - 1], tour[j]) + tour_step(matrix, tour[i], tour[j + 1]) -
+                                 tour_step(matrix, tour[i - 1], tour[i]) - tour_step(matrix, tour[j], tour[j + 1]);
+
+            if (delta >= 0)
+                continue;
+
+            for (size_t a = i, b = j; a < b; ++a, --b) {
+                uint32_t t = tour[a];
+                tour[a] = tour[b];
+                tour[b] = t;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool tour_or_opt(const tour_matrix_t *matrix, tour_t tour) {
+    size_t size = cvector_size(tour);
+    uint32_t segment[TOUR_SEGMENT];
+
+    for (size_t length = 1; length <= TOUR_SEGMENT; ++length) {
+        for (size_t i = 1; i + length < size; ++i) {
+            uint32_t first = tour[i], last = tour[i + length - 1];
+            uint32_t before = tour[i - 1], after = tour[i + length];
+            int_fast64_t saved = tour_step(matrix, before, first) + tour_step(matrix, last, after) -
+                                 tour_step(matrix, before, after);
+
+            // The segment is placed between tour[k] and tour[k + 1], outside of its current place.
+            for (size_t k = 0; k + 1 < size; ++k) {
+                if (k + 1 >= i && k < i + length)
+                    continue;
+
+                uint32_t from = tour[k], to = tour[k + 1];
+                int_fast64_t gap = tour_step(matrix, from, to);
+                int_fast64_t forward = tour_step(matrix, from, first) + tour_step(matrix, last, to) - gap;
+                int_fast64_t reversed = tour_step(matrix, from, last) + tour_step(matrix, first, to) - gap;
+                bool reverse = reversed < forward;
+
+                if ((reverse ? reversed : forward) >= saved)
+                    continue;
+
+                for (size_t s = 0; s < length; ++s)
+                    segment[s] = tour[reverse ? i + length - 1 - s : i + s];
+
+                // Shifts the coins between the two places and writes the segment in the gap.
+                if (k < i) {
+                    memmove(&tour[k + 1 + length], &tour[k + 1], (i - k - 1) * sizeof(uint32_t));
+                    memcpy(&tour[k + 1], segment, length * sizeof(uint32_t));
+                } else {
+                    memmove(&tour[i], &tour[i + length], (k + 1 - i - length) * sizeof(uint32_t));
+                    memcpy(&tour[k + 1 - length], segment, length * sizeof(uint32_t));
+                }
+
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+size_t tour_improve(const tour_matrix_t *matrix, tour_t *tour, double deadline) {
+    bool *used = (bool *) PROGRAM_CALLOC(matrix->size, sizeof(bool));
+    size_t moves = 0;
+
+    for (size_t i = 0; i < cvector_size(*tour); ++i)
+        used[(*tour)[i]] = true;
+
+    /*
+     * First improvement: the cheapest moves are tried first and
+     * the search starts again after every move that is applied.
+     */
+    while (solver_now() < deadline) {
+        bool moved = tour_remove(matrix, *tour, used) || tour_insert(matrix, tour, used) ||
+                     tour_two_opt(matrix, *tour) || tour_or_opt(matrix, *tour);
+
+        if (!moved)
+            break;
+
+        moves++;
+    }
+
+    PROGRAM_FREE(used);
+    return moves;
+}
+
+path_t tour_refine_with(const tour_matrix_t *matrix, maze_t maze, path_t path, double deadline) {
+    if (!path || tour_distance(matrix, 0, matrix->size - 1) == TOUR_UNREACHABLE)
+        return path;
+
+    tour_t tour = tour_extract(matrix, maze, path);
+    size_t moves = tour_improve(matrix, &tour, deadline);
+    path_t improved = moves > 0 ? tour_stitch(matrix, maze, tour, NULL) : NULL;
+
+    cvector_free(tour);
+
+    /*
+     * The tour is scored on the distances alone, the paths are replayed
+     * with the rules of the game, body cuts included, before comparing
+     * them and the new one is taken only when it scores strictly more.
+     */
+    solver_collect(maze, path);
+    if (improved)
+        solver_collect(maze, improved);
+
+    if (improved && solver_score(improved) > solver_score(path)) {
+        cvector_free(path);
+        return improved;
+    }
+
+    cvector_free(improved);
+    return path;
+}
+
+path_t tour_refine(maze_t maze, path_t path, double deadline) {
+    if (!path)
+        return NULL;
+
+    tour_matrix_t matrix;
+    tour_init_matrix(&matrix, maze);
+
+    path = tour_refine_with(&matrix, maze, path, deadline);
+
+    tour_free_matrix(matrix);
+    return path;
+}
+
+path_t tour_execute(maze_t maze) {
+    tour_matrix_t matrix;
+    tour_init_matrix(&matrix, maze);
+
+    tour_t tour = tour_solve(&matrix);
+    path_t path = tour ? tour_stitch(&matrix, maze, tour, NULL) : solver_execute_full(maze);
+
+    if (tour && PROGRAM_SOLVER_IMPROVE_TIMEOUT > 0)
+        path = tour_refine_with(&matrix, maze, path, solver_now() + PROGRAM_SOLVER_IMPROVE_TIMEOUT);
+
+    cvector_free(tour);
+    tour_free_matrix(matrix);
+    return path;
+}
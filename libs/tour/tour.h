@@ -0,0 +1,238 @@
+/**
+ * @file tour.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the tour solver
+ *
+ * These file contains functions that solve the maze as an
+ * orienteering problem: the shortest distances between the
+ * start, the end and the coins are computed once, then the
+ * order of the coins to collect is chosen on those distances
+ * and the legs are joined at the end, on the junction graph
+ * when the maze contracts well and with a* otherwise.
+ */
+
+#ifndef SNAKE_TOUR_H
+#define SNAKE_TOUR_H
+
+#include "../core/core.h"
+#include "../configuration.h"
+#include "../vector/cvector.h"
+#include "../bitmap/bitmap.h"
+#include "../solver/solver.h"
+#include "../graph/graph.h"
+
+/**
+ * @details Value of a collected coin, measured in steps.
+ *
+ * A coin is worth a detour when it costs fewer steps than this.
+ */
+#define TOUR_COIN_VALUE 10
+
+/**
+ * @details Distance between two points that
+ * cannot reach each other.
+ */
+#define TOUR_UNREACHABLE UINT32_MAX
+
+/**
+ * @details Most coins whose order is chosen exactly,
+ * the bitmask dp uses <tt>2 ^ coins * coins</tt> entries.
+ *
+ * With more coins the order is built by cheapest insertion.
+ */
+#define TOUR_EXACT_COINS 16
+
+/**
+ * @details Most coins stored in the matrix, when the maze
+ * has more coins only the ones with the shortest detour
+ * from the start to end path are considered.
+ */
+#define TOUR_MAX_COINS 512
+
+/**
+ * @details The distances between the coins are measured on the
+ * junction graph when it has at least this many times fewer
+ * nodes than the open blocks of the maze, otherwise on the blocks.
+ *
+ * @see graph_t
+ */
+#define TOUR_GRAPH_CONTRACTION 4
+
+/**
+ * @details Most coins moved together by the or-opt
+ * moves of the local search.
+ */
+#define TOUR_SEGMENT 3
+
+/**
+ * @brief Struct that contains the distances between the points of interest.
+ *
+ * The first point is the start, the last one is the end and
+ * the coins are stored between them. The distances are measured
+ * on a view of the maze where the drills are removed, walking only
+ * on blocks that are not walls or dangers and never passing on the end.
+ */
+typedef struct tour_matrix {
+    maze_t view; /**< Copy of the maze without drills, used by every search */
+    path_t points; /**< Start, the coins and the end */
+    uint32_t *distances; /**< Distance between every couple of points, row by row */
+    size_t size; /**< How many points are stored */
+    graph_t graph; /**< Junction graph of the view, the coins are nodes */
+    bool contracted; /**< If the graph is used, see TOUR_GRAPH_CONTRACTION */
+} tour_matrix_t;
+
+/**
+ * @brief Typedef to create a vector of point indexes
+ *
+ * Uses the library cvector.h to define a new type
+ * and use it as a dynamic vector.
+ *
+ * Represents the order in which the points of a tour_matrix_t
+ * are visited, from the start (0) to the end (size - 1).
+ */
+typedef cvector_vector_type(uint32_t) tour_t;
+
+/**
+ * @brief Returns the distance between two points.
+ *
+ * @param matrix Pointer to the tour_matrix_t
+ * @param from Index of the first point
+ * @param to Index of the second point
+ * @return The distance or TOUR_UNREACHABLE.
+ */
+#define tour_distance(matrix, from, to) ((matrix)->distances[(size_t) (from) * (matrix)->size + (to)])
+
+/**
+ * @brief Computes the distances between the points of interest
+ *
+ * Runs a breadth-first search from every point, so the matrix is built
+ * in O(points * cells). On mazes made of corridors the searches from
+ * the coins run on the junction graph, in O(points * nodes * log(nodes)).
+ * The coins that the start cannot reach are not stored.
+ *
+ * Remember after using the matrix to free the allocated
+ * memory by calling tour_free_matrix.
+ *
+ * @param matrix Pointer to the matrix object
+ * @param maze Maze where the distances are measured
+ */
+void tour_init_matrix(tour_matrix_t *matrix, maze_t maze)__attribute__((nonnull));
+
+/**
+ * @brief Frees the matrix used space.
+ *
+ * @param matrix Matrix that needs to be deallocated
+ * @warning tour_init_matrix must be called before calling this function.
+ */
+void tour_free_matrix(tour_matrix_t matrix);
+
+/**
+ * @brief Chooses which coins to collect and in which order
+ *
+ * Maximizes TOUR_COIN_VALUE for every coin minus the length of the tour.
+ * Up to TOUR_EXACT_COINS coins the order is optimal (bitmask dp),
+ * with more coins they are inserted where they cost less until
+ * no coin is worth its detour.
+ *
+ * @param matrix Pointer to the matrix object
+ * @return The order of the points, NULL if the end cannot be reached.
+ */
+tour_t tour_solve(const tour_matrix_t *matrix)__attribute__((nonnull));
+
+/**
+ * @brief Builds the path that follows a tour
+ *
+ * Every leg is searched on the view of the matrix, coins already
+ * collected by a previous leg are skipped. When the graph of the
+ * matrix is contracted the leg is the shortest path on its edges,
+ * unless it crosses the body, then it's searched with a*.
+ * The locations of the path hold the coins, drills and dangers
+ * collected until them. Once @p control expires the coins left
+ * are skipped and the last leg goes straight to the end.
+ *
+ * @param matrix Pointer to the matrix object
+ * @param maze Maze where the path is walked
+ * @param tour Order of the points
+ * @param control Deadline and cancel flag of the legs, NULL to join every leg
+ * @return A vector of locations to reach end from start.
+ */
+path_t tour_stitch(const tour_matrix_t *matrix, maze_t maze, tour_t tour,
+                   const solver_control_t *control)__attribute__((nonnull(1)));
+
+/**
+ * @brief Returns the order in which a path collects the coins
+ *
+ * Coins that are not stored in the matrix are ignored,
+ * every coin is taken where the path reaches it first.
+ *
+ * @param matrix Pointer to the matrix object
+ * @param maze Maze where the path is walked
+ * @param path Path from the start to the end
+ * @return The order of the points, from the start to the end.
+ */
+tour_t tour_extract(const tour_matrix_t *matrix, maze_t maze, path_t path)__attribute__((nonnull(1)));
+
+/**
+ * @brief Improves a tour with local search
+ *
+ * Applies the first move that raises the value of the tour until
+ * none does or the deadline passes. The moves are the removal of a
+ * coin that costs more than TOUR_COIN_VALUE, the insertion of a coin
+ * that costs less, the reversal of a segment (2-opt) and the move of
+ * up to TOUR_SEGMENT coins somewhere else (or-opt). Every move is
+ * measured on the distances of the matrix.
+ *
+ * @param matrix Pointer to the matrix object
+ * @param tour Pointer to the tour, changed in place
+ * @param deadline Value of solver_now when the search stops
+ * @return How many moves have been applied.
+ */
+size_t tour_improve(const tour_matrix_t *matrix, tour_t *tour, double deadline)__attribute__((nonnull));
+
+/**
+ * @brief Improves a path by changing the order of its coins
+ *
+ * The coins collected by the path are improved with tour_improve
+ * and joined again with tour_stitch. Both paths are replayed with
+ * solver_collect, so the scores compared are the ones given by the
+ * game, and the new path is returned only when it scores more than
+ * @p path, otherwise @p path is returned.
+ *
+ * @param matrix Pointer to the matrix object
+ * @param maze Maze where the path is walked
+ * @param path Path to be improved, freed when it's replaced
+ * @param deadline Value of solver_now when the search stops
+ * @return A path that scores at least as much as @p path.
+ */
+path_t tour_refine_with(const tour_matrix_t *matrix, maze_t maze, path_t path, double deadline)__attribute__((nonnull(1)));
+
+/**
+ * @brief Improves a path by changing the order of its coins
+ *
+ * Works as tour_refine_with, the matrix is computed on @p maze.
+ *
+ * @param maze Maze where the path is walked
+ * @param path Path to be improved, freed when it's replaced
+ * @param deadline Value of solver_now when the search stops
+ * @return A path that scores at least as much as @p path, NULL if @p path is NULL.
+ */
+path_t tour_refine(maze_t maze, path_t path, double deadline);
+
+/**
+ * @brief Runs the tour solver
+ *
+ * Computes the matrix, chooses the coins and joins the legs,
+ * the cost depends on the number of coins and not on the
+ * paths that can be walked inside the maze. The path is then
+ * improved by tour_refine_with for PROGRAM_SOLVER_IMPROVE_TIMEOUT seconds.
+ *
+ * When the end can only be reached by drilling or through
+ * dangers solver_execute_full is ran instead.
+ *
+ * @param maze Maze where the algorithm has to be ran
+ * @return Null if there is no path or a vector of locations to reach end from start.
+ */
+path_t tour_execute(maze_t maze);
+
+#endif //SNAKE_TOUR_H
@@ -0,0 +1,67 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "transposition.h"
+
+static uint64_t zobrist_mix(uint64_t value) {
+    // splitmix64, every input gives a well distributed output.
+    value += ZOBRIST_SEED;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9u;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBu;
+    return value ^ (value >> 31);
+}
+
+void zobrist_init(zobrist_t *z, size_t size) {
+    z->positions = (uint64_t *) PROGRAM_MALLOC(size * sizeof(uint64_t));
+    z->collected = (uint64_t *) PROGRAM_MALLOC(size * sizeof(uint64_t));
+
+    for (size_t i = 0; i < size; ++i) {
+        z->positions[i] = zobrist_mix(i * 4 + 2);
+        z->collected[i] = zobrist_mix(i * 4 + 3);
+    }
+}
+
+void zobrist_free(zobrist_t z) {
+    PROGRAM_FREE(z.positions);
+    PROGRAM_FREE(z.collected);
+}
+
+uint64_t zobrist_counter(zobrist_kind_t kind, uint_fast32_t value) {
+    // Counters and blocks never mix the same input.
+    return zobrist_mix((uint64_t) value * 4 + kind);
+}
+
+void transposition_init(transposition_t *t, uint_fast8_t bits) {
+    size_t size = (size_t) 1 << bits;
+
+    t->entries = (transposition_entry_t *) PROGRAM_CALLOC(size, sizeof(transposition_entry_t));
+    t->mask = size - 1;
+    t->hits = 0;
+    t->misses = 0;
+    t->overwrites = 0;
+}
+
+void transposition_free(transposition_t t) {
+    PROGRAM_FREE(t.entries);
+}
+
+bool transposition_dominated(transposition_t *t, uint64_t key, uint32_t cost, uint16_t coins) {
+    transposition_entry_t *entry = &t->entries[key & t->mask];
+
+    // Equal states are both kept, a path can't revisit its blocks so they aren't interchangeable.
+    if (entry->key == key && entry->cost <= cost && entry->coins >= coins &&
+        (entry->cost < cost || entry->coins > coins)) {
+        t->hits++;
+        return true;
+    }
+
+    if (entry->key != 0 && entry->key != key)
+        t->overwrites++;
+
+    t->misses++;
+    entry->key = key;
+    entry->cost = cost;
+    entry->coins = coins;
+    return false;
+}
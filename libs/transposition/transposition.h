@@ -0,0 +1,146 @@
+/**
+ * @file transposition.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains a fixed size transposition table
+ *
+ * These file contains a hash table of fixed size, used to
+ * detect when a search reaches again a state that it already
+ * reached in a better way, and the Zobrist keys used to hash
+ * the states incrementally.
+ */
+
+#ifndef SNAKE_TRANSPOSITION_H
+#define SNAKE_TRANSPOSITION_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../configuration.h"
+#include "../rpmalloc/rpmalloc.h"
+
+/**
+ * @details Seed of the generator of the Zobrist keys,
+ * fixed so that every run hashes the states in the same way.
+ */
+#define ZOBRIST_SEED 0x9E3779B97F4A7C15u
+
+/**
+ * @brief Counters that can be hashed next to a position.
+ *
+ * @see zobrist_counter
+ */
+typedef enum zobrist_kind {
+    ZOBRIST_DRILLS = 0, ZOBRIST_DANGERS = 1
+} zobrist_kind_t;
+
+/**
+ * @brief Struct that contains the Zobrist keys of a maze.
+ *
+ * Every block has a random key for being the current position
+ * and one for being collected. The hash of a state is the xor of the
+ * keys of its parts, so a move updates it with a couple of xor:
+ * the key of the old position is removed and the one of the new
+ * position is added.
+ */
+typedef struct zobrist {
+    uint64_t *positions; /**< Key of every block used as current position */
+    uint64_t *collected; /**< Key of every block collected by the path */
+} zobrist_t;
+
+/**
+ * @brief Struct that represents an entry of the transposition table.
+ *
+ * A key of 0 means that the entry is empty.
+ */
+typedef struct transposition_entry {
+    uint64_t key; /**< Hash of the stored state */
+    uint32_t cost; /**< Lowest cost found to reach the state */
+    uint16_t coins; /**< Coins held when reaching the state with that cost */
+} transposition_entry_t;
+
+/**
+ * @brief Struct that represents a transposition table.
+ *
+ * The table is direct-mapped: the low bits of the key select the entry
+ * and a different state mapped on the same entry replaces it, so the
+ * memory used never grows after transposition_init.
+ */
+typedef struct transposition {
+    transposition_entry_t *entries; /**< Entries of the table */
+    uint64_t mask; /**< Number of entries minus one */
+    uint_fast64_t hits; /**< Probes that found a dominating state */
+    uint_fast64_t misses; /**< Probes that stored their state */
+    uint_fast64_t overwrites; /**< Misses that replaced a different state */
+} transposition_t;
+
+/**
+ * @brief Allocates the Zobrist keys of a maze
+ *
+ * Remember after using the keys to free the allocated
+ * memory by calling zobrist_free.
+ *
+ * @param z Pointer to the keys object
+ * @param size How many blocks are stored in the maze
+ */
+void zobrist_init(zobrist_t *z, size_t size)__attribute__((nonnull));
+
+/**
+ * @brief Frees the Zobrist keys used space.
+ *
+ * @param z Keys that need to be deallocated
+ * @warning zobrist_init must be called before calling this function.
+ */
+void zobrist_free(zobrist_t z);
+
+/**
+ * @brief Returns the Zobrist key of a counter.
+ *
+ * Counters are unbounded, so their keys are computed
+ * by mixing the value instead of being stored.
+ *
+ * @param kind Which counter is hashed
+ * @param value Value of the counter
+ * @return The key of @p value.
+ */
+uint64_t zobrist_counter(zobrist_kind_t kind, uint_fast32_t value);
+
+/**
+ * @brief Allocates space for the table
+ *
+ * Every entry is initialized empty.
+ *
+ * Remember after using the table to free the allocated
+ * memory by calling transposition_free.
+ *
+ * @param t Pointer to the table object
+ * @param bits The table holds 2 ^ bits entries
+ */
+void transposition_init(transposition_t *t, uint_fast8_t bits)__attribute__((nonnull));
+
+/**
+ * @brief Frees the table used space.
+ *
+ * @param t Table that needs to be deallocated
+ * @warning transposition_init must be called before calling this function.
+ */
+void transposition_free(transposition_t t);
+
+/**
+ * @brief Probes the table with a state.
+ *
+ * The state is dominated when the table already holds it with
+ * a lower or equal cost and at least as many coins, and it's worse
+ * in at least one of them, in that case the table is left untouched.
+ * Otherwise the state is stored, replacing the entry it's mapped on.
+ *
+ * @param t Pointer to the table object
+ * @param key Hash of the state, must not be 0
+ * @param cost Cost of the state
+ * @param coins Coins held by the state
+ * @return True if the state is dominated and can be dropped.
+ */
+bool transposition_dominated(transposition_t *t, uint64_t key, uint32_t cost, uint16_t coins)__attribute__((nonnull));
+
+#endif //SNAKE_TRANSPOSITION_H
@@ -0,0 +1,193 @@
+//
+// Created by agent on 17/10/26.
+//
+
+#include "tree.h"
+
+/**
+ * @brief Struct that contains the tree of a maze.
+ */
+typedef struct tree {
+    maze_t maze; /**< Maze of the tree */
+    uint32_t end; /**< Block of the end */
+    uint32_t *parents; /**< Parent of every block, TREE_NONE if not reachable */
+    uint32_t *order; /**< Reachable blocks, in breadth-first order from the start */
+    uint32_t count; /**< How many blocks are reachable */
+} tree_t;
+
+static uint32_t tree_neighbor(maze_t maze, uint32_t block, move_t direction) {
+    location_t location = {block % maze.width, block / maze.width};
+    location_t neighbor = core_get_neighbor(location, direction, 1);
+
+    if (!core_is_in_bounds(maze, neighbor))
+        return TREE_NONE;
+
+    uint32_t index = (uint32_t) neighbor.x + (uint32_t) neighbor.y * maze.width;
+    return maze.blocks[index] == SNAKE_WALL_CHAR ? TREE_NONE : index;
+}
+
+static bool tree_init(tree_t *tree, maze_t maze) {
+    uint32_t cells = (uint32_t) maze.width * maze.height;
+    uint32_t start = (uint32_t) maze.start.x + (uint32_t) maze.start.y * maze.width;
+
+    tree->maze = maze;
+    tree->end = (uint32_t) maze.end.x + (uint32_t) maze.end.y * maze.width;
+    tree->parents = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    tree->order = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    tree->count = (uint32_t) solver_execute_field(maze, start, tree->end, true, tree->parents, NULL, tree->order,
+                                                  NULL);
+
+    /*
+     * A breadth-first search from the start, the end is never crossed.
+     * Every open neighbor of a reached block is either its parent or
+     * its child, any other block closes a cycle.
+     */
+    for (uint32_t head = 0; head < tree->count; ++head) {
+        uint32_t block = tree->order[head];
+        if (maze.blocks[block] == SNAKE_DRILL_CHAR)
+            return false;
+
+        if (block == tree->end)
+            continue;
+
+        for (move_t i = MOVE_LEFT; i <= MOVE_DOWN; ++i) {
+            uint32_t neighbor = tree_neighbor(maze, block, i);
+
+            if (neighbor != TREE_NONE && neighbor != tree->parents[block] && tree->parents[neighbor] != block)
+                return false;
+        }
+    }
+
+    return tree->parents[tree->end] != TREE_NONE;
+}
+
+static void tree_free(tree_t tree) {
+    PROGRAM_FREE(tree.parents);
+    PROGRAM_FREE(tree.order);
+}
+
+static uint_fast16_t tree_replay(maze_t maze, const uint32_t *spine, size_t from, size_t length,
+                                 uint_fast16_t coins) {
+    // The blocks of the path to the end are walked once, a danger keeps the upper half of the coins.
+    for (size_t i = from; i < length; ++i) {
+        if (maze.blocks[spine[i]] == SNAKE_COIN_CHAR)
+            coins++;
+        else if (maze.blocks[spine[i]] == SNAKE_DANGER_CHAR)
+            coins -= coins / 2;
+    }
+
+    return coins;
+}
+
+static void tree_detour(const tree_t *tree, const uint32_t *spine, size_t first, size_t length,
+                        cvector_vector_type(uint32_t) *detour) {
+    uint32_t cells = (uint32_t) tree->maze.width * tree->maze.height;
+    uint32_t *queue = (uint32_t *) PROGRAM_MALLOC(cells * sizeof(uint32_t));
+    uint8_t *reached = (uint8_t *) PROGRAM_CALLOC(cells, sizeof(uint8_t));
+    uint32_t head = 0, tail = 0, coin = TREE_NONE;
+
+    // The blocks of the path to the end are marked with 2, the ones of the branches with 1.
+    for (size_t i = 0; i < length; ++i)
+        reached[spine[i]] = 2;
+
+    for (size_t i = 0; i < first; ++i)
+        queue[tail++] = spine[i];
+
+    // A breadth-first search from the blocks walked without coins, the first coin found is the closest.
+    while (head < tail && coin == TREE_NONE) {
+        uint32_t block = queue[head++];
+
+        for (move_t i = MOVE_LEFT; i <= MOVE_DOWN && coin == TREE_NONE; ++i) {
+            uint32_t neighbor = tree_neighbor(tree->maze, block, i);
+
+            if (neighbor == TREE_NONE || reached[neighbor])
+                continue;
+
+            reached[neighbor] = 1;
+            queue[tail++] = neighbor;
+
+            if (tree->maze.blocks[neighbor] == SNAKE_COIN_CHAR)
+                coin = neighbor;
+        }
+    }
+
+    // The blocks from the coin back to the path to the end.
+    for (uint32_t block = coin; block != TREE_NONE && reached[block] == 1; block = tree->parents[block])
+        cvector_push_back(*detour, block);
+
+    PROGRAM_FREE(queue);
+    PROGRAM_FREE(reached);
+}
+
+static void tree_push(maze_t maze, path_t *path, uint32_t block) {
+    location_t location = {block % maze.width, block / maze.width};
+    cvector_push_back(*path, location);
+}
+
+path_t tree_execute(maze_t maze) {
+    tree_t tree;
+
+    if (!tree_init(&tree, maze)) {
+        tree_free(tree);
+        return NULL;
+    }
+
+    // The path to the end, from the start.
+    uint32_t start = tree.order[0];
+    cvector_vector_type(uint32_t) spine = NULL;
+    for (uint32_t block = tree.end; block != start; block = tree.parents[block])
+        cvector_push_back(spine, block);
+    cvector_push_back(spine, start);
+
+    size_t length = cvector_size(spine);
+    for (size_t i = 0; i < length / 2; ++i) {
+        uint32_t block = spine[i];
+        spine[i] = spine[length - 1 - i];
+        spine[length - 1 - i] = block;
+    }
+
+    size_t first = 1;
+    while (first < length && maze.blocks[spine[first]] != SNAKE_COIN_CHAR)
+        first++;
+
+    /*
+     * Walking back on the previous block steps on the body and cuts
+     * it to a single block, so a detour holding coins never pays. The
+     * only one worth its moves enters, while no coin is held, the
+     * closest branch with a coin and starts the path with one coin.
+     */
+    cvector_vector_type(uint32_t) detour = NULL;
+    tree_detour(&tree, spine, first, length, &detour);
+
+    uint32_t entry = TREE_NONE;
+    if (!cvector_empty(detour)) {
+        int_fast64_t gain = 10 * ((int_fast64_t) tree_replay(maze, spine, first, length, 1) -
+                                  (int_fast64_t) tree_replay(maze, spine, first, length, 0));
+
+        if (gain > 2 * (int_fast64_t) cvector_size(detour))
+            entry = tree.parents[*cvector_last(detour)];
+    }
+
+    path_t path = NULL;
+
+    for (size_t i = 0; i < length; ++i) {
+        tree_push(maze, &path, spine[i]);
+
+        if (spine[i] != entry)
+            continue;
+
+        // Out to the coin and back on the same blocks.
+        for (size_t k = cvector_size(detour); k-- > 0;)
+            tree_push(maze, &path, detour[k]);
+        for (size_t k = 1; k < cvector_size(detour); ++k)
+            tree_push(maze, &path, detour[k]);
+        tree_push(maze, &path, entry);
+    }
+
+    solver_collect(maze, path);
+
+    cvector_free(detour);
+    cvector_free(spine);
+    tree_free(tree);
+    return path;
+}
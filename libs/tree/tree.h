@@ -0,0 +1,50 @@
+/**
+ * @file tree.h
+ * @author agent
+ * @date 17/10/2026
+ * @brief Header that contains the solver of the tree shaped mazes
+ *
+ * These file contains functions that solve the mazes whose blocks
+ * form a tree, like the ones built by the generator, with a few
+ * linear passes over the blocks instead of a search.
+ */
+
+#ifndef SNAKE_TREE_H
+#define SNAKE_TREE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../configuration.h"
+#include "../core/core.h"
+#include "../vector/cvector.h"
+#include "../solver/solver.h"
+
+/**
+ * @details Block of the tree that has no parent.
+ */
+#define TREE_NONE UINT32_MAX
+
+/**
+ * @brief Solves a maze whose blocks form a tree
+ *
+ * The maze is a tree when the blocks reachable from the start
+ * without crossing the end have no cycle and no drill. The path to
+ * the end is then unique and every other block is reached with a
+ * detour that walks back to where it started.
+ *
+ * Walking back on the previous block steps on the body and cuts it
+ * to a single block, so a detour taken while holding coins never
+ * scores more. The solver walks the path to the end and takes at
+ * most one detour, before the first coin of that path, to the
+ * closest coin of a branch when starting with one coin instead of
+ * none is worth the moves. The path is the best one, found in
+ * O(width * height).
+ *
+ * @param maze Maze to be solved
+ * @return The path from the start to the end, NULL if the maze is not a tree.
+ */
+path_t tree_execute(maze_t maze);
+
+#endif //SNAKE_TREE_H
@@ -26,6 +26,8 @@
  *      - @c PROGRAM_OUTPUT_COLORS This allows the program to use terminal colors,
  *              enabled by default. Set it to @c false if you are seeing random stuff on the terminal.
  *      - @c PROGRAM_SOLVER_TIMEOUT This is the timeout of the solver, set by default to @c 60 seconds.
+ *      - @c PROGRAM_ALLOCATION_STATISTICS This counts the calls to the memory allocator, reported by
+ *              the benchmark. Disabled by default.
  *  @warning Please adjust the settings based on your system!!!
  *
  *  @section installation Installation
@@ -60,6 +62,10 @@
  *      - <tt>--file <path></tt> Parses a maze from the specified file.
  *      - <tt>--generate <width> <height></tt> Generates a maze and uses it in the game.
  *      - <tt>--challenge</tt> Runs the challenge mode, @see game_mode
+ *      - <tt>--benchmark [paths...]</tt> Measures the solvers on the specified files and on generated mazes.
+ *      - <tt>--verify [paths...]</tt> Checks that the searches find paths of the same length on the specified files.
+ *      - <tt>--beam <width> [score|optimistic]</tt> The computer mode runs a beam search that keeps
+ *              @c width paths, ranked by their score or by their optimistic score.
  *
  *  @section troubleshooting Troubleshooting
  *
@@ -97,6 +103,11 @@
 #include "./libs/configuration.h"
 #include "./libs/core/core.h"
 #include "./libs/runtime/runtime.h"
+#include "./libs/benchmark/benchmark.h"
+
+#if defined(PROGRAM_ALLOCATION_STATISTICS) && PROGRAM_ALLOCATION_STATISTICS == true
+size_t program_allocations = 0;
+#endif
 
 void *
 get_input(char **argv, uint_fast16_t i, uint_fast16_t size, bool *out_generate_flag, int *out_width, int *out_height) {
@@ -140,6 +151,25 @@ int main(int argc, char **argv) {
 
     bool parsed = false;
     for (int i = 0; i < argc; ++i) {
+        if (strcmp("--benchmark", argv[i]) == 0) {
+            benchmark_run(argv + i + 1, argc - i - 1);
+            core_free_maze(maze);
+            exit(EXIT_SUCCESS);
+        }
+
+        if (strcmp("--verify", argv[i]) == 0) {
+            size_t failures = benchmark_verify(argv + i + 1, argc - i - 1);
+            core_free_maze(maze);
+            exit(failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        if (strcmp("--beam", argv[i]) == 0 && i + 1 < argc) {
+            bool optimistic = i + 2 >= argc || strcmp("score", argv[i + 2]) != 0;
+            runtime_set_beam((size_t) strtoul(argv[i + 1], NULL, 10),
+                             optimistic ? SOLVER_BEAM_OPTIMISTIC : SOLVER_BEAM_SCORE);
+            continue;
+        }
+
         bool generate = false;
         void *input = get_input(argv, i, argc, &generate, &generated_width, &generated_height);
 
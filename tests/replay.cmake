@@ -0,0 +1,51 @@
+# Plays the path of the ai mode in the interactive mode and checks that
+# the score printed by the ai mode is the one given by the game.
+#
+# cmake -DSNAKE=<path of the executable> -DMAZE=<path of the maze> -DWORK=<directory> -P replay.cmake
+
+cmake_minimum_required(VERSION 3.22.1)
+
+# The colors printed by the game are removed before reading the scores.
+string(ASCII 27 escape)
+
+get_filename_component(name "${MAZE}" NAME_WE)
+get_filename_component(level "${MAZE}" DIRECTORY)
+get_filename_component(level "${level}" NAME)
+set(prefix "${WORK}/replay_${level}_${name}")
+
+file(WRITE "${prefix}_ai.txt" "3\n1\n")
+execute_process(COMMAND "${SNAKE}" --file "${MAZE}" INPUT_FILE "${prefix}_ai.txt"
+        OUTPUT_VARIABLE output RESULT_VARIABLE result)
+string(REGEX REPLACE "${escape}\\[[0-9;]*m" "" output "${output}")
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "The ai mode exited with ${result}")
+endif ()
+
+if (NOT output MATCHES "Score: (-?[0-9]+)")
+    message(FATAL_ERROR "The ai mode printed no score:\n${output}")
+endif ()
+set(claimed "${CMAKE_MATCH_1}")
+
+if (NOT output MATCHES "Movements: *([NESO]*)")
+    message(FATAL_ERROR "The ai mode printed no movements:\n${output}")
+endif ()
+set(movements "${CMAKE_MATCH_1}")
+
+# Every movement is a line of the interactive mode, then it exits.
+string(REGEX REPLACE "([NESO])" "\\1\n" lines "${movements}")
+file(WRITE "${prefix}_interactive.txt" "2\n${lines}1\n")
+execute_process(COMMAND "${SNAKE}" --file "${MAZE}" INPUT_FILE "${prefix}_interactive.txt"
+        OUTPUT_VARIABLE output RESULT_VARIABLE result)
+string(REGEX REPLACE "${escape}\\[[0-9;]*m" "" output "${output}")
+
+if (NOT output MATCHES "Your score is: (-?[0-9]+)")
+    message(FATAL_ERROR "The interactive mode printed no score:\n${output}")
+endif ()
+set(real "${CMAKE_MATCH_1}")
+
+if (NOT claimed EQUAL real)
+    message(FATAL_ERROR "The ai mode claims ${claimed} but the path scores ${real}")
+endif ()
+
+message(STATUS "${MAZE}: ${real}")
@@ -0,0 +1,485 @@
+/**
+ * @file tests.c
+ * @author agent
+ * @date 17/10/2026
+ * @brief Checks of the solvers ran by ctest
+ *
+ * These file contains the checks of the solvers on crafted
+ * mazes, every check is selected by its name on the command
+ * line and the program exits with a failure when it fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../libs/configuration.h"
+#include "../libs/core/core.h"
+#include "../libs/queue/queue.h"
+#include "../libs/solver/solver.h"
+#include "../libs/transposition/transposition.h"
+#include "../libs/components/components.h"
+#include "../libs/reduction/reduction.h"
+#include "../libs/graph/graph.h"
+#include "../libs/tree/tree.h"
+
+#if defined(PROGRAM_ALLOCATION_STATISTICS) && PROGRAM_ALLOCATION_STATISTICS == true
+size_t program_allocations = 0;
+#endif
+
+/**
+ * @details Fails the running check when @p condition is false.
+ */
+#define TESTS_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            return false; \
+        } \
+    } while (0)
+
+/**
+ * @brief Struct that contains a check.
+ */
+typedef struct tests_check {
+    const char *name; /**< Name used to select the check */
+    bool (*run)(void); /**< Runs the check, false if it fails */
+} tests_check_t;
+
+static maze_t tests_maze(const char *text) {
+    FILE *file = fmemopen((void *) text, strlen(text), "r");
+    maze_t maze = core_parse_maze(file);
+
+    fclose(file);
+    return maze;
+}
+
+static size_t tests_astar_length(maze_t maze, location_t end, queue_kind_t kind) {
+    solver_workspace_t w;
+    path_t path = NULL;
+
+    solver_init_workspace(&w, maze);
+    solver_set_workspace_queue(&w, kind);
+
+    size_t length = solver_execute_astar_into(&w, maze, maze.start, end, NULL, true, &path) ? cvector_size(path) : 0;
+
+    cvector_free(path);
+    solver_free_workspace(w);
+    return length;
+}
+
+static int_fast32_t tests_full_score(maze_t maze, bool precise, solver_statistics_t *statistics) {
+    // A precise search doesn't stop on the estimated coins.
+    solver_control_t control = {solver_now() + PROGRAM_SOLVER_TIMEOUT, precise};
+    path_t path = solver_execute_controlled(maze, &control, statistics);
+    int_fast32_t score = solver_score(path);
+
+    cvector_free(path);
+    return score;
+}
+
+static bool tests_queue(void) {
+    queue_t heap, bucket;
+    queue_init(&heap, 4096, QUEUE_HEAP);
+    queue_init(&bucket, 4096, QUEUE_BUCKET);
+
+    /*
+     * Pops like a search does, every popped key pushes keys that are not
+     * lower, some farther than QUEUE_BUCKETS so they go in the overflow
+     * lane, and some queued elements get a lower key. The first key
+     * pushed is the lowest, as the start of a search.
+     */
+    static uint_fast32_t keys[4096];
+    srand(7);
+    for (uint32_t i = 0; i < 64; ++i) {
+        keys[i] = i == 0 ? 0 : rand() % 8;
+        queue_push(&heap, i, queue_compose_priority(keys[i], 0));
+        queue_push(&bucket, i, queue_compose_priority(keys[i], 0));
+    }
+
+    uint32_t pushed = 64;
+    while (!queue_empty(&heap)) {
+        TESTS_CHECK(!queue_empty(&bucket));
+
+        uint_fast32_t key = keys[queue_pop(&heap)];
+        TESTS_CHECK(key == keys[queue_pop(&bucket)]);
+
+        for (uint_fast8_t k = 0; k < 3 && pushed < 4096; ++k, ++pushed) {
+            keys[pushed] = key + (rand() % 10 == 0 ? QUEUE_BUCKETS + rand() % QUEUE_BUCKETS : rand() % 4);
+            queue_push(&heap, pushed, queue_compose_priority(keys[pushed], 0));
+            queue_push(&bucket, pushed, queue_compose_priority(keys[pushed], 0));
+        }
+
+        // The elements with the same key can be popped in another order, only the ones in both are lowered.
+        uint32_t lowered = (uint32_t) rand() % pushed;
+        if (queue_contains(&heap, lowered) && queue_contains(&bucket, lowered)) {
+            uint_fast32_t lower = key + rand() % 2;
+
+            TESTS_CHECK(queue_push(&heap, lowered, queue_compose_priority(lower, 0)) ==
+                        queue_push(&bucket, lowered, queue_compose_priority(lower, 0)));
+
+            if (lower < keys[lowered])
+                keys[lowered] = lower;
+        }
+    }
+
+    TESTS_CHECK(queue_empty(&bucket));
+    queue_free(heap);
+    queue_free(bucket);
+
+    // The a* finds paths of the same length with both backends.
+    maze_t maze = tests_maze("9\n5\n"
+                             "#o#######\n"
+                             "# $   # #\n"
+                             "# ### # #\n"
+                             "#   $   _\n"
+                             "#########\n");
+    location_t coin = {2, 1};
+
+    TESTS_CHECK(tests_astar_length(maze, maze.end, QUEUE_BUCKET) == tests_astar_length(maze, maze.end, QUEUE_HEAP));
+    TESTS_CHECK(tests_astar_length(maze, maze.end, QUEUE_BUCKET) == 11);
+    TESTS_CHECK(tests_astar_length(maze, coin, QUEUE_BUCKET) == 3);
+
+    core_free_maze(maze);
+    return true;
+}
+
+static bool tests_transposition(void) {
+    transposition_t table;
+    transposition_init(&table, 4);
+
+    // A state is dropped only when it's reached again with no less cost and no more coins.
+    TESTS_CHECK(!transposition_dominated(&table, 17, 10, 2));
+    TESTS_CHECK(transposition_dominated(&table, 17, 11, 2));
+    TESTS_CHECK(transposition_dominated(&table, 17, 10, 1));
+    TESTS_CHECK(!transposition_dominated(&table, 17, 10, 2));
+    TESTS_CHECK(!transposition_dominated(&table, 17, 12, 3));
+    TESTS_CHECK(!transposition_dominated(&table, 17, 9, 3));
+    TESTS_CHECK(transposition_dominated(&table, 17, 12, 3));
+    TESTS_CHECK(table.hits == 3 && table.overwrites == 0);
+
+    // A different state on the same entry replaces it.
+    TESTS_CHECK(!transposition_dominated(&table, 33, 20, 0));
+    TESTS_CHECK(table.overwrites == 1);
+    TESTS_CHECK(!transposition_dominated(&table, 17, 12, 3));
+    transposition_free(table);
+
+    zobrist_t keys;
+    zobrist_init(&keys, 64);
+    TESTS_CHECK(keys.positions[5] != keys.positions[6] && keys.positions[5] != keys.collected[5]);
+    TESTS_CHECK(zobrist_counter(ZOBRIST_DRILLS, 1) != zobrist_counter(ZOBRIST_DANGERS, 1));
+    zobrist_free(keys);
+
+    /*
+     * The room is crossed by many paths that reach the same states,
+     * the table drops them and the best path is still found: 10 moves
+     * with the 4 coins.
+     */
+    maze_t maze = tests_maze("7\n5\n"
+                             "#o#####\n"
+                             "#  $  #\n"
+                             "# $#$ #\n"
+                             "#    $_\n"
+                             "#######\n");
+    solver_statistics_t statistics;
+
+    TESTS_CHECK(tests_full_score(maze, true, &statistics) == 1030);
+    TESTS_CHECK(PROGRAM_SOLVER_TRANSPOSITION_BITS == 0 || statistics.transposition_hits > 0);
+
+    core_free_maze(maze);
+    return true;
+}
+
+static bool tests_labels(void) {
+    /*
+     * The danger halves the coins, so some paths reach a block with
+     * no more coins than a shorter one that collected a part of their
+     * blocks: their labels are dominated and dropped, the transposition
+     * table can't see it as the states differ. The best path is still
+     * found, 10 moves with 4 coins.
+     */
+    maze_t maze = tests_maze("7\n5\n"
+                             "#o#####\n"
+                             "#  $  #\n"
+                             "# $#$ #\n"
+                             "#!   $_\n"
+                             "#######\n");
+    solver_statistics_t statistics;
+
+    TESTS_CHECK(tests_full_score(maze, true, &statistics) == 1030);
+    TESTS_CHECK(!PROGRAM_SOLVER_PARETO || statistics.labels_dominated + statistics.labels_removed > 0);
+
+    core_free_maze(maze);
+    return true;
+}
+
+static bool tests_components(void) {
+    // The coin at (5, 1) is closed by walls, a single wall divides it from the start.
+    maze_t maze = tests_maze("9\n5\n"
+                             "#o#######\n"
+                             "# $ #$# #\n"
+                             "#   ### #\n"
+                             "# $     _\n"
+                             "#########\n");
+    location_t coin = {2, 1}, closed = {5, 1}, wall = {4, 1};
+    components_t components;
+    components_init(&components, maze);
+
+    uint32_t first = components_label(&components, maze, maze.start);
+    uint32_t second = components_label(&components, maze, closed);
+
+    TESTS_CHECK(components_label(&components, maze, wall) == COMPONENTS_NONE);
+    TESTS_CHECK(components_label(&components, maze, coin) == first && second != first);
+    TESTS_CHECK(components_connected(&components, maze, maze.start, maze.end));
+    TESTS_CHECK(components_connected(&components, maze, maze.start, coin));
+    TESTS_CHECK(!components_connected(&components, maze, maze.start, closed));
+    TESTS_CHECK(components_adjacent(&components, first, second) && components_adjacent(&components, second, first));
+
+    // Without drills the closed coin is removed, the others are kept.
+    maze_t view = core_duplicate_maze(maze);
+    TESTS_CHECK(components_prune(&components, view) == 1);
+    TESTS_CHECK(*core_get_block_location(view, closed) == ' ');
+    TESTS_CHECK(*core_get_block_location(view, coin) == SNAKE_COIN_CHAR);
+    core_free_maze(view);
+    components_free(components);
+
+    // A drill in the component of the start can open the walls, every coin is kept.
+    *core_get_block_location(maze, (location_t) {1, 2}) = SNAKE_DRILL_CHAR;
+    components_init(&components, maze);
+    TESTS_CHECK(components_prune(&components, maze) == 0);
+    TESTS_CHECK(*core_get_block_location(maze, closed) == SNAKE_COIN_CHAR);
+    components_free(components);
+
+    core_free_maze(maze);
+    return true;
+}
+
+static bool tests_reduction(void) {
+    // The branch at the top is a dead end, danger included, the one on the right ends on a coin.
+    maze_t maze = tests_maze("9\n5\n"
+                             "#o#######\n"
+                             "# #!  #$#\n"
+                             "# ### # #\n"
+                             "#  $    _\n"
+                             "#########\n");
+    const char *filled = "#o#######\n"
+                         "# #####$#\n"
+                         "# ##### #\n"
+                         "#  $    _\n"
+                         "#########\n";
+
+    TESTS_CHECK(reduction_fill_dead_ends(maze) == 4);
+    for (int y = 0; y < maze.height; ++y) {
+        for (int x = 0; x < maze.width; ++x) {
+            TESTS_CHECK(maze.blocks[x + y * maze.width] == filled[x + y * (maze.width + 1)]);
+        }
+    }
+
+    TESTS_CHECK(reduction_fill_dead_ends(maze) == 0);
+    core_free_maze(maze);
+
+    // A filled block could be drilled, with a drill nothing is filled.
+    maze = tests_maze("5\n3\n"
+                      "#o###\n"
+                      "#T  _\n"
+                      "#  ##\n");
+    TESTS_CHECK(reduction_fill_dead_ends(maze) == 0);
+
+    core_free_maze(maze);
+    return true;
+}
+
+static bool tests_graph(void) {
+    /*
+     * The corridors are contracted into edges between the start, the
+     * end, the three junctions and the dead end on the right, the
+     * coins are nodes only when asked.
+     */
+    maze_t maze = tests_maze("9\n5\n"
+                             "#o#######\n"
+                             "# $   # #\n"
+                             "# ### # #\n"
+                             "#   $   _\n"
+                             "#########\n");
+    location_t coin = {2, 1};
+    graph_t graph;
+    graph_init(&graph, maze, false);
+
+    uint32_t start = graph.nodes[maze.start.x + maze.start.y * maze.width];
+    uint32_t end = graph.nodes[maze.end.x + maze.end.y * maze.width];
+
+    TESTS_CHECK(start != GRAPH_NONE && end != GRAPH_NONE);
+    TESTS_CHECK(graph.nodes[coin.x + coin.y * maze.width] == GRAPH_NONE);
+    TESTS_CHECK(graph.count == 6);
+
+    // Every corridor is stored from both its ends with the same length and coins.
+    for (uint32_t node = 0; node < graph.count; ++node) {
+        for (uint32_t i = graph.offsets[node]; i < graph.offsets[node + 1]; ++i) {
+            const graph_edge_t *edge = &graph.edges[i];
+            bool reversed = false;
+
+            for (uint32_t k = graph.offsets[edge->to]; k < graph.offsets[edge->to + 1]; ++k) {
+                const graph_edge_t *back = &graph.edges[k];
+                reversed |= back->to == node && back->length == edge->length && back->coins == edge->coins;
+            }
+
+            TESTS_CHECK(reversed);
+        }
+    }
+
+    // The expanded path is the one of the a* on the blocks.
+    path_t path = graph_execute_shortest(&graph, maze, true, start, end);
+    TESTS_CHECK(path != NULL && cvector_size(path) == tests_astar_length(maze, maze.end, QUEUE_HEAP));
+    for (size_t i = 1; i < cvector_size(path); ++i)
+        TESTS_CHECK(abs((int) path[i].x - (int) path[i - 1].x) + abs((int) path[i].y - (int) path[i - 1].y) == 1);
+
+    cvector_free(path);
+    graph_free(graph);
+
+    graph_init(&graph, maze, true);
+    TESTS_CHECK(graph.nodes[coin.x + coin.y * maze.width] != GRAPH_NONE);
+    TESTS_CHECK(graph.count == 8);
+    graph_free(graph);
+
+    // A danger splits its corridor, the end is then reached only by walking it.
+    location_t danger = {6, 3};
+    maze.blocks[danger.x + danger.y * maze.width] = SNAKE_DANGER_CHAR;
+    graph_init(&graph, maze, false);
+    TESTS_CHECK(graph.nodes[danger.x + danger.y * maze.width] != GRAPH_NONE);
+    TESTS_CHECK(graph.count == 7);
+
+    start = graph.nodes[maze.start.x + maze.start.y * maze.width];
+    end = graph.nodes[maze.end.x + maze.end.y * maze.width];
+    path = graph_execute_shortest(&graph, maze, false, start, end);
+    TESTS_CHECK(path == NULL);
+
+    path = graph_execute_shortest(&graph, maze, true, start, end);
+    TESTS_CHECK(path != NULL && cvector_size(path) == tests_astar_length(maze, maze.end, QUEUE_HEAP));
+
+    cvector_free(path);
+    graph_free(graph);
+
+    core_free_maze(maze);
+    return true;
+}
+
+static void tests_tree_carve(maze_t maze, int x, int y) {
+    static const int dx[4] = {-1, 0, 1, 0}, dy[4] = {0, -1, 0, 1};
+    int directions[4] = {0, 1, 2, 3};
+
+    maze.blocks[x + y * maze.width] = ' ';
+    for (int i = 3; i > 0; --i) {
+        int k = rand() % (i + 1), swap = directions[i];
+        directions[i] = directions[k];
+        directions[k] = swap;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        int nx = x + 2 * dx[directions[i]], ny = y + 2 * dy[directions[i]];
+
+        if (nx < 1 || ny < 1 || nx >= maze.width - 1 || ny >= maze.height - 1 ||
+            maze.blocks[nx + ny * maze.width] != SNAKE_WALL_CHAR)
+            continue;
+
+        maze.blocks[x + dx[directions[i]] + (y + dy[directions[i]]) * maze.width] = ' ';
+        tests_tree_carve(maze, nx, ny);
+    }
+}
+
+static bool tests_tree(void) {
+    /*
+     * Small perfect mazes, carved as the generator does but without
+     * drills, with coins and dangers on the branches and on the path
+     * to the end: the tree solver scores as the precise full solver.
+     */
+    srand(11);
+    for (int seed = 0; seed < 24; ++seed) {
+        maze_t maze = {seed % 2 == 0 ? 7 : 9, 7};
+        core_init_maze(&maze);
+        for (int i = 0; i < maze.width * maze.height; ++i)
+            maze.blocks[i] = SNAKE_WALL_CHAR;
+
+        tests_tree_carve(maze, 1, 1);
+        for (int i = 0; i < maze.width * maze.height; ++i) {
+            int chance = rand() % 100;
+
+            if (maze.blocks[i] == ' ' && chance < 25)
+                maze.blocks[i] = SNAKE_COIN_CHAR;
+            else if (maze.blocks[i] == ' ' && chance < 33)
+                maze.blocks[i] = SNAKE_DANGER_CHAR;
+        }
+
+        maze.start = (location_t) {0, 1};
+        maze.end = (location_t) {maze.width - 1, maze.height - 2};
+        *core_get_block_location(maze, maze.start) = SNAKE_PLAYER_CHAR;
+        *core_get_block_location(maze, maze.end) = SNAKE_END_CHAR;
+
+        solver_statistics_t statistics;
+        path_t path = tree_execute(maze);
+
+        TESTS_CHECK(path != NULL);
+        TESTS_CHECK(path[cvector_size(path) - 1].x == maze.end.x && path[cvector_size(path) - 1].y == maze.end.y);
+        for (size_t i = 1; i < cvector_size(path); ++i)
+            TESTS_CHECK(abs((int) path[i].x - (int) path[i - 1].x) + abs((int) path[i].y - (int) path[i - 1].y) == 1);
+
+        TESTS_CHECK(solver_score(path) >= tests_full_score(maze, true, &statistics));
+
+        cvector_free(path);
+        core_free_maze(maze);
+    }
+
+    return true;
+}
+
+static bool tests_estimate(void) {
+    /*
+     * The coins can only be reached through the danger next to the start,
+     * walked before collecting anything it takes nothing. They must be
+     * estimated, or the search takes the shortest path at once: 13 moves
+     * with the 8 coins instead of none.
+     */
+    maze_t maze = tests_maze("11\n6\n"
+                             "#o#########\n"
+                             "#!       T#\n"
+                             "# ####### #\n"
+                             "# ####### #\n"
+                             "#$$$$$$$$ #\n"
+                             "#########_#\n");
+    solver_statistics_t statistics;
+
+    TESTS_CHECK(tests_full_score(maze, false, &statistics) == 1067);
+    TESTS_CHECK(tests_full_score(maze, true, &statistics) == 1067);
+
+    core_free_maze(maze);
+    return true;
+}
+
+static const tests_check_t tests_checks[] = {
+        {"queue", tests_queue},
+        {"transposition", tests_transposition},
+        {"labels", tests_labels},
+        {"components", tests_components},
+        {"reduction", tests_reduction},
+        {"graph", tests_graph},
+        {"tree", tests_tree},
+        {"estimate", tests_estimate},
+};
+
+int main(int argc, char **argv) {
+#if defined(PROGRAM_RP_ALLOCATOR) && PROGRAM_RP_ALLOCATOR == true
+    rpmalloc_initialize();
+#endif
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <check>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < sizeof(tests_checks) / sizeof(*tests_checks); ++i) {
+        if (strcmp(tests_checks[i].name, argv[1]) == 0)
+            return tests_checks[i].run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    fprintf(stderr, "Unknown check %s\n", argv[1]);
+    return EXIT_FAILURE;
+}